@@ -0,0 +1,156 @@
+#include "ansiparser.h"
+
+#include <QVarLengthArray>
+
+namespace
+{
+
+constexpr char Escape = '\x1b';
+constexpr char Bell = '\x07';
+
+bool isControl(char c)
+{
+    const uchar byte = uchar(c);
+    return (byte < 0x20 && c != '\t') || byte == 0x7f;
+}
+
+} // namespace
+
+bool AnsiParser::process(QByteArrayView line, QByteArray *text, StyleSpans *spans)
+{
+    bool hasControls = false;
+    for (char c : line) {
+        if (isControl(c)) {
+            hasControls = true;
+            break;
+        }
+    }
+    if (!hasControls && style == 0) return false;
+
+    text->truncate(0);
+    spans->clear();
+
+    quint32 runStyle = style;
+    qsizetype runStart = 0;
+    auto closeRun = [&]() {
+        if (runStyle != 0 && text->size() > runStart) {
+            spans->append({quint32(runStart), quint32(text->size() - runStart), runStyle});
+        }
+        runStyle = style;
+        runStart = text->size();
+    };
+
+    const qsizetype size = line.size();
+    qsizetype i = 0;
+    while (i < size) {
+        const char c = line[i];
+        if (!isControl(c)) {
+            // Copy the plain run in one go
+            qsizetype end = i + 1;
+            while (end < size && !isControl(line[end])) ++end;
+            text->append(line.data() + i, end - i);
+            i = end;
+            continue;
+        }
+
+        if (c != Escape || i + 1 >= size) {
+            ++i;
+            continue;
+        }
+
+        const char kind = line[i + 1];
+        if (kind == '[') {
+            // CSI: parameter and intermediate bytes, then one final byte
+            qsizetype end = i + 2;
+            while (end < size && (uchar(line[end]) < 0x40 || uchar(line[end]) > 0x7e)) ++end;
+            if (end < size && line[end] == 'm') {
+                applySgr(line.sliced(i + 2, end - i - 2));
+                if (style != runStyle) closeRun();
+            }
+            i = end + 1;
+        } else if (kind == ']') {
+            // OSC: terminated by BEL or ESC backslash
+            qsizetype end = i + 2;
+            while (end < size && line[end] != Bell && !(line[end] == Escape && end + 1 < size && line[end + 1] == '\\')) ++end;
+            i = end + (end < size && line[end] == Escape ? 2 : 1);
+        } else {
+            i += 2;
+        }
+    }
+    closeRun();
+    return true;
+}
+
+void AnsiParser::applySgr(QByteArrayView params)
+{
+    QVarLengthArray<int, 16> codes;
+    int value = 0;
+    bool hasValue = false;
+    for (char c : params) {
+        if (c >= '0' && c <= '9') {
+            value = value * 10 + (c - '0');
+            hasValue = true;
+        } else if (c == ';' || c == ':') {
+            codes.append(hasValue ? value : 0);
+            value = 0;
+            hasValue = false;
+        }
+    }
+    codes.append(hasValue ? value : 0);
+
+    for (qsizetype i = 0; i < codes.size(); ++i) {
+        const int code = codes[i];
+        if (code == 0) {
+            style = 0;
+        } else if (code == 1) {
+            style |= Bold;
+        } else if (code == 4) {
+            style |= Underline;
+        } else if (code == 22) {
+            style &= ~Bold;
+        } else if (code == 24) {
+            style &= ~Underline;
+        } else if (code >= 30 && code <= 37) {
+            style = (style & ~ColorMask) | HasColor | rgbForIndex(code - 30);
+        } else if (code >= 90 && code <= 97) {
+            style = (style & ~ColorMask) | HasColor | rgbForIndex(code - 90 + 8);
+        } else if (code == 39) {
+            style &= ~(ColorMask | HasColor);
+        } else if (code == 38 || code == 48) {
+            // Extended colors; backgrounds are parsed only to be skipped
+            quint32 rgb = 0;
+            bool valid = false;
+            if (i + 2 < codes.size() && codes[i + 1] == 5) {
+                rgb = rgbForIndex(codes[i + 2]);
+                valid = true;
+                i += 2;
+            } else if (i + 4 < codes.size() && codes[i + 1] == 2) {
+                rgb = (quint32(codes[i + 2] & 0xff) << 16) | (quint32(codes[i + 3] & 0xff) << 8) | quint32(codes[i + 4] & 0xff);
+                valid = true;
+                i += 4;
+            }
+            if (valid && code == 38) {
+                style = (style & ~ColorMask) | HasColor | rgb;
+            }
+        }
+    }
+}
+
+quint32 AnsiParser::rgbForIndex(int index)
+{
+    // xterm palette, tuned for the dark output view
+    static const quint32 basic[16] = {
+        0x000000, 0xcd3131, 0x0dbc79, 0xe5e510, 0x2472c8, 0xbc3fbc, 0x11a8cd, 0xe5e5e5,
+        0x666666, 0xf14c4c, 0x23d18b, 0xf5f543, 0x3b8eea, 0xd670d6, 0x29b8db, 0xffffff
+    };
+
+    if (index < 0 || index > 255) return basic[7];
+    if (index < 16) return basic[index];
+    if (index < 232) {
+        static const int levels[6] = {0, 95, 135, 175, 215, 255};
+        const int i = index - 16;
+        return (quint32(levels[i / 36]) << 16) | (quint32(levels[(i / 6) % 6]) << 8) | quint32(levels[i % 6]);
+    }
+    const quint32 gray = quint32(8 + (index - 232) * 10);
+    return (gray << 16) | (gray << 8) | gray;
+}
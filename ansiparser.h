@@ -0,0 +1,39 @@
+#ifndef ANSIPARSER_H
+#define ANSIPARSER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+#include "logline.h"
+
+// Streaming interpreter for the ANSI escapes in one output channel.
+//
+// SGR sequences (ESC [ ... m) update the current style, which carries over
+// from line to line like it does on a terminal; the runs they style are
+// reported as StyleSpans over the stripped text. Every other CSI, OSC and
+// two-byte escape, and stray C0 controls except tab, are removed.
+class AnsiParser
+{
+public:
+    // Style word layout
+    static constexpr quint32 ColorMask = 0x00ffffff;   // foreground RGB
+    static constexpr quint32 HasColor = 1u << 24;
+    static constexpr quint32 Bold = 1u << 25;
+    static constexpr quint32 Underline = 1u << 26;
+
+    // Returns false when the line needs no rewriting (no escapes, default
+    // style); otherwise writes the stripped text to *text and its styled
+    // runs to *spans, both cleared first.
+    bool process(QByteArrayView line, QByteArray *text, StyleSpans *spans);
+
+    void reset() { style = 0; }
+
+    static quint32 rgbForIndex(int index);
+
+private:
+    void applySgr(QByteArrayView params);
+
+    quint32 style = 0;
+};
+
+#endif // ANSIPARSER_H
@@ -0,0 +1,131 @@
+#include <QStringList>
+#include <QtTest>
+
+#include <numeric>
+
+#include "benchlog.h"
+#include "lineclassifier.h"
+#include "lineframer.h"
+
+// Cost of telling build lines apart, before and after the byte-level path.
+//
+// qStringChain is the original stdout handler: each read is decoded with
+// QString::fromUtf8 and split into lines, every line runs through a chain
+// of QString::contains() calls for its color, and the whole read through
+// another one for progress. byteLevel frames the same reads with LineFramer
+// and matches each line against all rules at once with LineClassifier.
+// Both get the log in ReadSize pieces, as from QProcess. The log is the
+// file named by $QT6_INSTALLER_BENCH_LOG (a recorded session log, say), or
+// else LinesPerRun synthetic ninja lines; its size is printed first.
+class ClassifyBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void qStringChain();
+    void byteLevel();
+
+private:
+    static constexpr int LinesPerRun = 100000;
+    static constexpr int WarningEvery = 50;
+    static constexpr qsizetype ReadSize = 64 * 1024;
+    static constexpr int ClassCount = int(LineClass::Stderr) + 1;
+
+    QByteArray log;
+    qsizetype lineCount = 0;
+};
+
+namespace
+{
+
+// The old color rules, first match wins
+LineClass chainClass(const QString &line)
+{
+    if (line.contains("[INFO]") || line.contains("Building") || line.contains("Configuring")) {
+        return LineClass::Info;
+    } else if (line.contains("[SUCCESS]") || line.contains("successfully") || line.contains("Complete")) {
+        return LineClass::Success;
+    } else if (line.contains("[WARNING]")) {
+        return LineClass::Warning;
+    } else if (line.contains("[ERROR]") || line.contains("error:") || line.contains("Error")) {
+        return LineClass::Error;
+    } else if (line.contains("===")) {
+        return LineClass::Section;
+    }
+    return LineClass::Plain;
+}
+
+// The old progress keywords, checked against a whole read
+int chainProgress(const QString &output)
+{
+    if (output.contains("Checking prerequisites")) return 5;
+    if (output.contains("llvm-mingw")) return 10;
+    if (output.contains("Qt6 source")) return 15;
+    if (output.contains("Configuring Qt6 host")) return 20;
+    if (output.contains("Building Qt6 host")) return 30;
+    if (output.contains("Installing Qt6 host")) return 50;
+    if (output.contains("Configuring Qt6 Windows")) return 55;
+    if (output.contains("Building Qt6 Windows")) return 70;
+    if (output.contains("Installing Qt6 Windows")) return 85;
+    if (output.contains("test application")) return 95;
+    if (output.contains("Installation Complete")) return 100;
+    return -1;
+}
+
+} // namespace
+
+void ClassifyBench::initTestCase()
+{
+    log = BenchLog::recorded();
+    if (log.isEmpty()) {
+        log = BenchLog::synthetic(LinesPerRun, WarningEvery);
+    }
+    lineCount = log.count('\n') + (log.endsWith('\n') ? 0 : 1);
+    qInfo("%lld lines, %lld bytes", qint64(lineCount), qint64(log.size()));
+}
+
+void ClassifyBench::qStringChain()
+{
+    QBENCHMARK {
+        qsizetype counts[ClassCount] = {};
+        int progress = -1;
+        for (qsizetype offset = 0; offset < log.size(); offset += ReadSize) {
+            const QString output = QString::fromUtf8(log.constData() + offset, qMin(ReadSize, log.size() - offset));
+            const QStringList lines = output.split('\n');
+            for (const QString &line : lines) {
+                if (line.isEmpty()) continue;
+                ++counts[int(chainClass(line))];
+            }
+            progress = qMax(progress, chainProgress(output));
+        }
+        QVERIFY(std::accumulate(std::begin(counts), std::end(counts), qsizetype(0)) > 0);
+        QVERIFY(progress <= 100);
+    }
+}
+
+void ClassifyBench::byteLevel()
+{
+    const LineClassifier classifier;
+
+    QBENCHMARK {
+        qsizetype counts[ClassCount] = {};
+        int progress = -1;
+        LineFramer framer;
+        auto sink = [&](QByteArrayView line) {
+            const LineClassifier::Result result = classifier.classify(line);
+            ++counts[int(result.lineClass)];
+            progress = qMax(progress, result.progress);
+        };
+        for (qsizetype offset = 0; offset < log.size(); offset += ReadSize) {
+            framer.feed(QByteArrayView(log).sliced(offset, qMin(ReadSize, log.size() - offset)), sink);
+        }
+        framer.finish(sink);
+        QCOMPARE(std::accumulate(std::begin(counts), std::end(counts), qsizetype(0)), lineCount);
+        QVERIFY(progress <= 100);
+    }
+}
+
+QTEST_APPLESS_MAIN(ClassifyBench)
+
+#include "bench_classify.moc"
@@ -0,0 +1,216 @@
+#include <QApplication>
+#include <QListView>
+#include <QScrollBar>
+#include <QTextCharFormat>
+#include <QTextCursor>
+#include <QTextEdit>
+#include <QtTest>
+
+#include "ansiparser.h"
+#include "benchlog.h"
+#include "lineclassifier.h"
+#include "lineframer.h"
+#include "logdelegate.h"
+#include "logmodel.h"
+#include "sessionclock.h"
+
+// Throughput of the path a build line takes to the screen.
+//
+// Every benchmark handles LinesPerRun lines of a synthetic ninja log per
+// iteration, so lines/s is LinesPerRun divided by the reported time. The
+// log is mostly "[n/N] Building ..." status lines, with a colored compiler
+// warning every WarningEvery lines. Run with QT_QPA_PLATFORM=offscreen on
+// a machine without a display. textEditAppend is the baseline: the
+// original window's appendOutput(), one cursor insert per line into a
+// QTextEdit, with the event loop run once per read.
+class LogPipelineBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void framing();
+    void modelAppend_data();
+    void modelAppend();
+    void viewAppend_data();
+    void viewAppend();
+    void textEditAppend();
+
+private:
+    static constexpr int LinesPerRun = 100000;
+    static constexpr int WarningEvery = 50;
+    static constexpr qsizetype ReadSize = 64 * 1024;
+
+    LogLineBatch classify(QByteArrayView log);
+
+    QByteArray log;
+    LogLineBatch lines;
+};
+
+namespace
+{
+
+// The GUI's flush: one appendLines() per frame of batchSize lines
+void appendInFrames(LogModel *model, const LogLineBatch &lines, int batchSize, QListView *view)
+{
+    for (qsizetype first = 0; first < lines.size(); first += batchSize) {
+        model->appendLines(lines.mid(first, batchSize));
+        if (view) {
+            view->scrollToBottom();
+            QCoreApplication::processEvents();
+        }
+    }
+}
+
+// The original window's colors
+QColor lineColor(LineClass lineClass)
+{
+    switch (lineClass) {
+    case LineClass::Info:
+        return Qt::blue;
+    case LineClass::Success:
+        return Qt::darkGreen;
+    case LineClass::Warning:
+        return QColor(255, 140, 0);
+    case LineClass::Error:
+        return Qt::red;
+    case LineClass::Section:
+        return Qt::darkCyan;
+    default:
+        return Qt::black;
+    }
+}
+
+// The original appendOutput(), called once per line
+void appendOutput(QTextEdit *output, const QString &text, const QColor &color)
+{
+    QTextCharFormat format;
+    format.setForeground(QBrush(color));
+
+    QTextCursor cursor = output->textCursor();
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(text, format);
+
+    output->setTextCursor(cursor);
+    output->ensureCursorVisible();
+
+    QScrollBar *scrollBar = output->verticalScrollBar();
+    scrollBar->setValue(scrollBar->maximum());
+}
+
+} // namespace
+
+void LogPipelineBench::initTestCase()
+{
+    log = BenchLog::synthetic(LinesPerRun, WarningEvery);
+    lines = classify(log);
+    QCOMPARE(lines.size(), qsizetype(LinesPerRun));
+}
+
+// The worker's side, as in InstallWorker::appendLine: framing, escapes and classification
+LogLineBatch LogPipelineBench::classify(QByteArrayView data)
+{
+    LineFramer framer;
+    AnsiParser ansi;
+    LineClassifier classifier;
+    SessionClock clock;
+    QByteArray stripped;
+    LogLineBatch batch;
+    batch.reserve(LinesPerRun);
+
+    auto sink = [&](QByteArrayView bytes) {
+        StyleSpans spans;
+        if (ansi.process(bytes, &stripped, &spans)) {
+            bytes = stripped;
+        }
+        LogLine line{bytes.toByteArray(), LineClass::Plain, spans};
+        clock.stamp(&line, clock.elapsedUs());
+        const LineClassifier::Result result = classifier.classify(bytes);
+        line.lineClass = result.lineClass;
+        line.progress = result.progress;
+        batch.append(std::move(line));
+    };
+    for (qsizetype offset = 0; offset < data.size(); offset += ReadSize) {
+        framer.feed(data.sliced(offset, qMin(ReadSize, data.size() - offset)), sink);
+    }
+    framer.finish(sink);
+    return batch;
+}
+
+void LogPipelineBench::framing()
+{
+    QBENCHMARK {
+        const LogLineBatch batch = classify(log);
+        QCOMPARE(batch.size(), qsizetype(LinesPerRun));
+    }
+}
+
+void LogPipelineBench::modelAppend_data()
+{
+    QTest::addColumn<int>("batchSize");
+    QTest::newRow("1 line per flush") << 1;
+    QTest::newRow("1000 lines per flush") << 1000;
+    QTest::newRow("50000 lines per flush") << 50000;
+}
+
+void LogPipelineBench::modelAppend()
+{
+    QFETCH(int, batchSize);
+
+    QBENCHMARK {
+        LogModel model;
+        appendInFrames(&model, lines, batchSize, nullptr);
+        QCOMPARE(model.rowCount(), LinesPerRun);
+    }
+}
+
+void LogPipelineBench::viewAppend_data()
+{
+    modelAppend_data();
+}
+
+// The whole ceiling: rows inserted into a shown view that follows the tail
+void LogPipelineBench::viewAppend()
+{
+    QFETCH(int, batchSize);
+
+    QBENCHMARK {
+        LogModel model;
+        QListView view;
+        view.setModel(&model);
+        view.setItemDelegate(new LogDelegate(&view));
+        view.setUniformItemSizes(true);
+        view.resize(1000, 600);
+        view.show();
+        appendInFrames(&model, lines, batchSize, &view);
+        QCOMPARE(model.rowCount(), LinesPerRun);
+    }
+}
+
+// The old ceiling, before the model and view
+void LogPipelineBench::textEditAppend()
+{
+    QBENCHMARK {
+        QTextEdit output;
+        output.setReadOnly(true);
+        output.resize(1000, 600);
+        output.show();
+
+        // The old handler appended every line of a read, then returned to the event loop
+        qsizetype sinceRead = 0;
+        for (const LogLine &line : std::as_const(lines)) {
+            appendOutput(&output, QString::fromUtf8(line.text) + '\n', lineColor(line.lineClass));
+            sinceRead += line.text.size() + 1;
+            if (sinceRead >= ReadSize) {
+                QCoreApplication::processEvents();
+                sinceRead = 0;
+            }
+        }
+        QCoreApplication::processEvents();
+        QCOMPARE(output.document()->blockCount(), LinesPerRun + 1);
+    }
+}
+
+QTEST_MAIN(LogPipelineBench)
+
+#include "bench_logpipeline.moc"
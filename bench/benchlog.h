@@ -0,0 +1,49 @@
+#ifndef BENCHLOG_H
+#define BENCHLOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QtDebug>
+
+// Build logs the benchmarks run on
+namespace BenchLog
+{
+
+// lineCount lines of a ninja build: mostly "[n/N] Building ..." status
+// lines, with a colored compiler warning every warningEvery lines
+inline QByteArray synthetic(int lineCount, int warningEvery)
+{
+    QByteArray log;
+    const QByteArray total = QByteArray::number(lineCount);
+    for (int i = 0; i < lineCount; ++i) {
+        const QByteArray number = QByteArray::number(i);
+        if (i % warningEvery == warningEvery - 1) {
+            log += "\x1b[1m/src/qt6/qtbase/src/corelib/io/qfile" + number + ".cpp:" + QByteArray::number(i % 900 + 1)
+                 + ":12: \x1b[0;1;35mwarning: \x1b[0m\x1b[1munused variable 'size' [-Wunused-variable]\x1b[0m\n";
+        } else {
+            log += "[" + number + "/" + total + "] Building CXX object qtbase/src/corelib/CMakeFiles/Core.dir/io/qfile"
+                 + number + ".cpp.o\n";
+        }
+    }
+    return log;
+}
+
+// The file named by $QT6_INSTALLER_BENCH_LOG, such as a recorded session
+// log; empty if the variable is not set or the file cannot be read
+inline QByteArray recorded()
+{
+    const QString path = qEnvironmentVariable("QT6_INSTALLER_BENCH_LOG");
+    if (path.isEmpty()) return QByteArray();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "cannot read" << path << ":" << file.errorString();
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+} // namespace BenchLog
+
+#endif // BENCHLOG_H
@@ -0,0 +1,48 @@
+#!/bin/bash
+# CPU cost of relaying a build log through install.sh's output path.
+#
+# Compares the per-line loop every build step used to pipe through with
+# run_verbose's direct passthrough, on a recorded build log or, without one,
+# on a synthetic ninja log of BENCH_LINES lines. The output goes to
+# /dev/null, so only the script's own overhead is measured.
+#
+# Usage: bench/passthrough.sh [recorded-log]
+set -e
+
+BENCH_LINES="${BENCH_LINES:-500000}"
+
+if [ $# -ge 1 ]; then
+    LOG="$1"
+else
+    LOG="$(mktemp)"
+    trap 'rm -f "$LOG"' EXIT
+    awk -v n="$BENCH_LINES" 'BEGIN {
+        for (i = 1; i <= n; i++)
+            printf "[%d/%d] Building CXX object qtbase/src/corelib/CMakeFiles/Core.dir/io/qfile%d.cpp.o\n", i, n, i
+    }' > "$LOG"
+fi
+
+# The real helpers, taken from install.sh; sourcing all of it would start a build
+INSTALL_SH="$(dirname "$0")/../install.sh"
+eval "$(sed -n -e '/^NC=/p' -e '/^VERBOSE=/p' \
+               -e '/^echo_verbose() {/,/^}/p' -e '/^run_verbose() {/,/^}/p' "$INSTALL_SH")"
+if ! declare -F echo_verbose run_verbose > /dev/null; then
+    echo "echo_verbose or run_verbose not found in $INSTALL_SH" >&2
+    exit 1
+fi
+
+read_loop() {
+    cat "$LOG" 2>&1 | while IFS= read -r line; do
+        echo_verbose "$line"
+    done
+}
+
+passthrough() {
+    run_verbose cat "$LOG"
+}
+
+echo "Log: $LOG ($(wc -l < "$LOG" | tr -d ' ') lines, $(wc -c < "$LOG" | tr -d ' ') bytes)"
+for bench in read_loop passthrough; do
+    TIMEFORMAT="  $bench: %U s user, %S s system, %R s elapsed"
+    time "$bench" > /dev/null
+done
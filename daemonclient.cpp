@@ -0,0 +1,295 @@
+#include "daemonclient.h"
+
+#include <QCoreApplication>
+#include <QLocalSocket>
+#include <QTimer>
+
+#include <utility>
+
+using DaemonProtocol::Message;
+
+DaemonClient::DaemonClient(LogBatchQueue *queue, SessionClock *clock, QObject *parent)
+    : QObject(parent)
+    , socket(new QLocalSocket(this))
+    , retryTimer(new QTimer(this))
+    , connectTimer(new QTimer(this))
+    , queue(queue)
+    , clock(clock)
+{
+    connect(socket, &QLocalSocket::connected, this, &DaemonClient::handleConnected);
+    connect(socket, &QLocalSocket::disconnected, this, &DaemonClient::handleDisconnected);
+    connect(socket, &QLocalSocket::errorOccurred, this, &DaemonClient::handleConnectError);
+    connect(socket, &QLocalSocket::readyRead, this, &DaemonClient::readDaemon);
+
+    // The queue was full: keep accumulating and try again next frame
+    retryTimer->setInterval(RetryIntervalMs);
+    connect(retryTimer, &QTimer::timeout, this, &DaemonClient::publish);
+
+    // A freshly launched daemon needs a moment before it listens
+    connectTimer->setSingleShot(true);
+    connectTimer->setInterval(ConnectRetryMs);
+    connect(connectTimer, &QTimer::timeout, this, [this]() {
+        socket->connectToServer(serverPath);
+    });
+}
+
+void DaemonClient::attach()
+{
+    if (state == State::Disconnected) {
+        connectToDaemon(true, false);
+    }
+}
+
+void DaemonClient::start(const QString &program, const QStringList &arguments, const QProcessEnvironment &environment)
+{
+    if (state == State::Disconnected) {
+        connectToDaemon(false, true);
+    }
+    // An attach() still in flight may launch the daemon too now
+    spawn = true;
+    send(DaemonProtocol::frame(Message::Start, program, arguments, environment.toStringList()));
+}
+
+void DaemonClient::stop()
+{
+    send(DaemonProtocol::frame(Message::Stop));
+}
+
+void DaemonClient::setPaused(bool paused)
+{
+    send(DaemonProtocol::frame(Message::Pause, paused));
+}
+
+void DaemonClient::shutdown()
+{
+    // Only the window goes away; the daemon carries on with the build
+    connectTimer->stop();
+    pendingFrames.clear();
+    if (state == State::Connected) {
+        state = State::Disconnected;
+        socket->flush();
+        socket->disconnectFromServer();
+    } else {
+        state = State::Disconnected;
+        socket->abort();
+    }
+}
+
+void DaemonClient::connectToDaemon(bool replayLines, bool spawnDaemon)
+{
+    state = State::Connecting;
+    replay = replayLines;
+    spawn = spawnDaemon;
+    detachedByDaemon = false;
+    spawnTimer.invalidate();
+    reader.clear();
+
+    serverPath = DaemonProtocol::serverName();
+    if (serverPath.isEmpty()) {
+        // Deferred, so a start() in progress has queued its request and hears about it
+        QTimer::singleShot(0, this, [this]() {
+            if (state == State::Connecting) giveUp("no private runtime directory for its socket");
+        });
+        return;
+    }
+    socket->connectToServer(serverPath);
+}
+
+void DaemonClient::send(const QByteArray &frame)
+{
+    if (state == State::Connected) {
+        socket->write(frame);
+    } else if (state == State::Connecting) {
+        pendingFrames.append(frame);
+    }
+}
+
+void DaemonClient::handleConnected()
+{
+    // Not our daemon: it gets neither the Start request nor the environment
+    if (!DaemonProtocol::peerIsCurrentUser(socket->socketDescriptor())) {
+        giveUp("its socket is held by another user");
+        socket->abort();
+        return;
+    }
+
+    state = State::Connected;
+    socket->write(DaemonProtocol::frame(Message::Hello, DaemonProtocol::Version, replay));
+    for (const QByteArray &frame : std::as_const(pendingFrames)) {
+        socket->write(frame);
+    }
+    pendingFrames.clear();
+}
+
+void DaemonClient::handleDisconnected()
+{
+    if (state != State::Connected) return;
+
+    state = State::Disconnected;
+    publish();
+    if (!detachedByDaemon) {
+        emit detached("Lost the connection to the installer daemon");
+    }
+}
+
+void DaemonClient::handleConnectError()
+{
+    if (state != State::Connecting) return;
+
+    if (!spawn) {
+        giveUp(socket->errorString());
+        return;
+    }
+    if (!spawnTimer.isValid()) {
+        // The daemon is this very executable, so both ends speak the same protocol
+        spawnTimer.start();
+        if (!QProcess::startDetached(QCoreApplication::applicationFilePath(), {"--daemon"})) {
+            giveUp("cannot launch it");
+            return;
+        }
+    }
+    if (spawnTimer.elapsed() >= SpawnTimeoutMs) {
+        giveUp(socket->errorString());
+        return;
+    }
+    connectTimer->start();
+}
+
+void DaemonClient::giveUp(const QString &errorString)
+{
+    state = State::Disconnected;
+    connectTimer->stop();
+
+    // A failed attach() is silent: there was simply no daemon to attach to
+    const bool startPending = !pendingFrames.isEmpty();
+    pendingFrames.clear();
+    if (!startPending) return;
+
+    const QString reason = QString("cannot reach the installer daemon: %1").arg(errorString);
+    LogLine line{QString("ERROR: Failed to start installation process! (%1)").arg(reason).toUtf8(), LineClass::Error};
+    line.channel = LogChannel::Installer;
+    clock->stamp(&line, clock->elapsedUs());
+    backlog.append(std::move(line));
+    verdict = {true, true, reason};
+    publish();
+}
+
+void DaemonClient::readDaemon()
+{
+    reader.feed(socket->readAll());
+
+    Message type;
+    QByteArray payload;
+    while (reader.next(&type, &payload)) {
+        handleMessage(type, payload);
+    }
+    if (reader.isBroken()) {
+        socket->abort();
+    }
+}
+
+void DaemonClient::handleMessage(Message type, const QByteArray &payload)
+{
+    QDataStream in(payload);
+    in.setVersion(DaemonProtocol::StreamVersion);
+
+    switch (type) {
+    case Message::Session: {
+        DaemonSession session;
+        in >> session;
+        emit attached(session);
+        if (session.running) {
+            emit progressChanged(session.percent, session.stepsDone, session.stepsTotal);
+            if (session.pid > 0) emit processStarted(session.pid);
+        }
+        break;
+    }
+    case Message::Lines: {
+        LogLineBatch lines;
+        in >> lines;
+        if (backlog.isEmpty()) {
+            backlog = std::move(lines);
+        } else {
+            backlog.append(lines);
+        }
+        publish();
+        break;
+    }
+    case Message::Progress: {
+        double percent = 0;
+        qint32 stepsDone = 0;
+        qint32 stepsTotal = 0;
+        in >> percent >> stepsDone >> stepsTotal;
+        emit progressChanged(percent, stepsDone, stepsTotal);
+        break;
+    }
+    case Message::Started: {
+        qint64 pid = 0;
+        in >> pid;
+        emit processStarted(pid);
+        break;
+    }
+    case Message::Paused: {
+        bool paused = false;
+        in >> paused;
+        emit pausedChanged(paused);
+        break;
+    }
+    case Message::FailedToStart: {
+        QString errorString;
+        in >> errorString;
+        verdict = {true, true, errorString};
+        publish();
+        break;
+    }
+    case Message::Finished: {
+        // Every line of the run reaches the consumer before the verdict
+        qint32 exitCode = 0;
+        quint8 exitStatus = 0;
+        in >> exitCode >> exitStatus;
+        verdict = {true, false, QString(), exitCode, QProcess::ExitStatus(exitStatus)};
+        publish();
+        break;
+    }
+    case Message::Detached: {
+        QString reason;
+        in >> reason;
+        detachedByDaemon = true;
+        emit detached(reason);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void DaemonClient::publish()
+{
+    if (!backlog.isEmpty() && queue->tryPush(std::move(backlog))) {
+        backlog = LogLineBatch();
+    }
+
+    if (backlog.isEmpty()) {
+        retryTimer->stop();
+    } else if (!retryTimer->isActive()) {
+        retryTimer->start();
+    }
+
+    if (!queue->isEmpty() && !wakeupPending.exchange(true, std::memory_order_acq_rel)) {
+        emit linesReady();
+    }
+
+    if (backlog.isEmpty() && verdict.pending) {
+        deliverVerdict();
+    }
+}
+
+void DaemonClient::deliverVerdict()
+{
+    const Verdict delivered = std::exchange(verdict, Verdict());
+    if (delivered.failed) {
+        emit failedToStart(delivered.errorString);
+    } else {
+        emit finished(delivered.exitCode, delivered.exitStatus);
+    }
+}
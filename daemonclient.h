@@ -0,0 +1,113 @@
+#ifndef DAEMONCLIENT_H
+#define DAEMONCLIENT_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+
+#include <atomic>
+
+#include "daemonprotocol.h"
+#include "installworker.h"
+#include "sessionclock.h"
+
+class QLocalSocket;
+class QTimer;
+
+// The GUI's end of the connection to InstallDaemon.
+//
+// Offers the same slots and signals as InstallWorker, so the window drives
+// a build in the daemon just like one of its own. Lines from the daemon,
+// replayed or live, are decoded here and handed over through the same
+// single-producer/single-consumer queue and linesReady() protocol, and
+// failedToStart() or finished() only follows once the last of them is in the
+// queue.
+// Nothing is sent until the daemon is known to run as the same user.
+// attach() only connects to a daemon that already runs; start() launches
+// one ("--daemon") if none answers and waits up to SpawnTimeoutMs for it.
+// shutdown() just disconnects: the build goes on without the window.
+// Lives on the worker thread.
+class DaemonClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    DaemonClient(LogBatchQueue *queue, SessionClock *clock, QObject *parent = nullptr);
+
+    // Called by the consumer right before it drains the queue
+    void acknowledgeLines() { wakeupPending.store(false, std::memory_order_release); }
+
+public slots:
+    void attach();
+    void start(const QString &program, const QStringList &arguments, const QProcessEnvironment &environment);
+    void stop();
+    void setPaused(bool paused);
+    void shutdown();
+
+signals:
+    void attached(const DaemonSession &session);
+    void detached(const QString &reason);
+    void linesReady();
+    void progressChanged(double percent, int stepsDone, int stepsTotal);
+    void processStarted(qint64 pid);
+    void pausedChanged(bool paused);
+    void failedToStart(const QString &errorString);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void handleConnected();
+    void handleDisconnected();
+    void handleConnectError();
+    void readDaemon();
+    void publish();
+
+private:
+    enum class State
+    {
+        Disconnected,
+        Connecting,
+        Connected
+    };
+
+    void connectToDaemon(bool replay, bool spawn);
+    void send(const QByteArray &frame);
+    void handleMessage(DaemonProtocol::Message type, const QByteArray &payload);
+    void giveUp(const QString &errorString);
+    void deliverVerdict();
+
+    static constexpr int RetryIntervalMs = 16;
+    static constexpr int ConnectRetryMs = 100;
+    static constexpr int SpawnTimeoutMs = 5000;
+
+    QLocalSocket *socket;
+    QTimer *retryTimer;
+    QTimer *connectTimer;
+    LogBatchQueue *queue;
+    SessionClock *clock;
+    DaemonProtocol::FrameReader reader;
+    QString serverPath;
+    QList<QByteArray> pendingFrames;    // sent once connected
+    QElapsedTimer spawnTimer;           // invalid until a daemon was launched
+    LogLineBatch backlog;               // lines not yet accepted by the queue
+
+    // failedToStart() or finished(), held back until the backlog is queued
+    struct Verdict
+    {
+        bool pending = false;
+        bool failed = false;
+        QString errorString;
+        int exitCode = 0;
+        QProcess::ExitStatus exitStatus = QProcess::NormalExit;
+    };
+
+    Verdict verdict;
+    std::atomic<bool> wakeupPending{false};
+    State state = State::Disconnected;
+    bool replay = false;
+    bool spawn = false;
+    bool detachedByDaemon = false;
+};
+
+#endif // DAEMONCLIENT_H
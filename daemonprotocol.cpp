@@ -0,0 +1,121 @@
+#include "daemonprotocol.h"
+
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QtEndian>
+
+#if defined(Q_OS_UNIX)
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+QString DaemonProtocol::serverName()
+{
+    const QString overrideName = qEnvironmentVariable("QT6_INSTALLER_DAEMON");
+    if (!overrideName.isEmpty()) return overrideName;
+
+#if defined(Q_OS_UNIX)
+    // A bare name would resolve to a socket in the shared temporary directory
+    const QString directory = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (directory.isEmpty()) return QString();
+
+    const QFileInfo info(directory);
+    const QFile::Permissions shared = QFile::ReadGroup | QFile::WriteGroup | QFile::ExeGroup
+                                      | QFile::ReadOther | QFile::WriteOther | QFile::ExeOther;
+    if (!info.isDir() || info.ownerId() != ::geteuid() || (info.permissions() & shared)) return QString();
+    return directory + "/qt6-installer-gui.sock";
+#else
+    QString user = qEnvironmentVariable("USER");
+    if (user.isEmpty()) user = qEnvironmentVariable("USERNAME");
+    return "qt6-installer-gui-" + user;
+#endif
+}
+
+bool DaemonProtocol::peerIsCurrentUser(qintptr socketDescriptor)
+{
+#if defined(Q_OS_LINUX)
+    ucred credentials{};
+    socklen_t size = sizeof(credentials);
+    if (::getsockopt(int(socketDescriptor), SOL_SOCKET, SO_PEERCRED, &credentials, &size) != 0) return false;
+    return credentials.uid == ::geteuid();
+#elif defined(Q_OS_UNIX)
+    uid_t uid = 0;
+    gid_t gid = 0;
+    if (::getpeereid(int(socketDescriptor), &uid, &gid) != 0) return false;
+    return uid == ::geteuid();
+#else
+    // The pipe is created with QLocalServer::UserAccessOption
+    Q_UNUSED(socketDescriptor);
+    return true;
+#endif
+}
+
+bool DaemonProtocol::FrameReader::next(Message *type, QByteArray *payload)
+{
+    if (broken) return false;
+
+    const qsizetype available = buffer.size() - offset;
+    if (available < qsizetype(sizeof(quint32))) return false;
+
+    const quint32 size = qFromBigEndian<quint32>(buffer.constData() + offset);
+    if (size == 0 || size > MaxPayloadSize) {
+        broken = true;
+        return false;
+    }
+    if (available < qsizetype(sizeof(quint32) + size)) return false;
+
+    const qsizetype begin = offset + sizeof(quint32);
+    *type = Message(quint8(buffer.at(begin)));
+    *payload = buffer.sliced(begin + 1, size - 1);
+    offset = begin + size;
+
+    // Drop consumed frames once they make up most of the buffer
+    if (offset > buffer.size() / 2) {
+        buffer.remove(0, offset);
+        offset = 0;
+    }
+    return true;
+}
+
+QDataStream &operator<<(QDataStream &out, const DaemonSession &session)
+{
+    return out << session.running << session.paused << session.pid << session.elapsedUs << session.qml
+               << session.jobs << session.percent << session.stepsDone << session.stepsTotal;
+}
+
+QDataStream &operator>>(QDataStream &in, DaemonSession &session)
+{
+    return in >> session.running >> session.paused >> session.pid >> session.elapsedUs >> session.qml
+              >> session.jobs >> session.percent >> session.stepsDone >> session.stepsTotal;
+}
+
+QDataStream &operator<<(QDataStream &out, const StyleSpan &span)
+{
+    return out << span.start << span.length << span.style;
+}
+
+QDataStream &operator>>(QDataStream &in, StyleSpan &span)
+{
+    return in >> span.start >> span.length >> span.style;
+}
+
+QDataStream &operator<<(QDataStream &out, const LogLine &line)
+{
+    return out << line.text << quint8(line.lineClass) << line.spans << quint8(line.channel) << line.sequence
+               << line.timestampUs << qint32(line.progress) << qint32(line.diagnostic);
+}
+
+QDataStream &operator>>(QDataStream &in, LogLine &line)
+{
+    quint8 lineClass = 0;
+    quint8 channel = 0;
+    qint32 progress = -1;
+    qint32 diagnostic = -1;
+    in >> line.text >> lineClass >> line.spans >> channel >> line.sequence >> line.timestampUs >> progress >> diagnostic;
+    line.lineClass = LineClass(lineClass);
+    line.channel = LogChannel(channel);
+    line.progress = progress;
+    line.diagnostic = diagnostic;
+    return in;
+}
@@ -0,0 +1,111 @@
+#ifndef DAEMONPROTOCOL_H
+#define DAEMONPROTOCOL_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+
+#include "logline.h"
+
+// Wire format between the GUI and the installer daemon.
+//
+// Every message is a frame: a 32-bit payload size, then a QDataStream
+// payload that starts with the message type. A client says Hello first;
+// the daemon answers with Session, the state of the current run, and then
+// with the lines of that run in large Lines frames before it goes live.
+namespace DaemonProtocol
+{
+
+constexpr quint32 Version = 1;
+constexpr QDataStream::Version StreamVersion = QDataStream::Qt_6_2;
+
+enum class Message : quint8
+{
+    // Client to daemon
+    Hello,          // quint32 version, bool replay
+    Start,          // QString program, QStringList arguments, QStringList environment
+    Stop,
+    Pause,          // bool paused
+
+    // Daemon to client
+    Session,        // DaemonSession
+    Lines,          // LogLineBatch
+    Progress,       // double percent, qint32 stepsDone, qint32 stepsTotal
+    Started,        // qint64 pid
+    Paused,         // bool paused
+    FailedToStart,  // QString errorString
+    Finished,       // qint32 exitCode, quint8 exitStatus
+    Detached        // QString reason; the daemon closes the connection
+};
+
+// $QT6_INSTALLER_DAEMON, or the full path of a socket in the user's private
+// runtime directory, so no other user can listen there first. On Windows,
+// a pipe name that is unique per user. Empty if the runtime directory is
+// missing or can be read by others.
+QString serverName();
+
+// True if the process at the other end of a connected local socket runs as
+// the current user. Both ends check this before any frame is exchanged.
+bool peerIsCurrentUser(qintptr socketDescriptor);
+
+// Builds one frame from the message type and its fields
+template <typename... Fields>
+QByteArray frame(Message type, const Fields &...fields)
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(StreamVersion);
+    out << quint32(0) << quint8(type);
+    (out << ... << fields);
+
+    const quint32 size = quint32(bytes.size() - sizeof(quint32));
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = char(size >> (24 - i * 8));
+    }
+    return bytes;
+}
+
+// Cuts a byte stream back into payloads
+class FrameReader
+{
+public:
+    // Payloads larger than this mean the stream is corrupt
+    static constexpr quint32 MaxPayloadSize = 64 * 1024 * 1024;
+
+    void feed(const QByteArray &bytes) { buffer += bytes; }
+
+    // Returns false when no complete frame is buffered, or on a broken stream
+    bool next(Message *type, QByteArray *payload);
+    bool isBroken() const { return broken; }
+    void clear() { buffer.clear(); offset = 0; broken = false; }
+
+private:
+    QByteArray buffer;
+    qsizetype offset = 0;
+    bool broken = false;
+};
+
+} // namespace DaemonProtocol
+
+// State of the daemon's run, as sent to a client that just attached
+struct DaemonSession
+{
+    bool running = false;
+    bool paused = false;
+    qint64 pid = 0;
+    qint64 elapsedUs = 0;       // on the daemon's session clock
+    bool qml = false;
+    qint32 jobs = 0;
+    double percent = 0;
+    qint32 stepsDone = 0;
+    qint32 stepsTotal = 0;
+};
+
+QDataStream &operator<<(QDataStream &out, const DaemonSession &session);
+QDataStream &operator>>(QDataStream &in, DaemonSession &session);
+QDataStream &operator<<(QDataStream &out, const StyleSpan &span);
+QDataStream &operator>>(QDataStream &in, StyleSpan &span);
+QDataStream &operator<<(QDataStream &out, const LogLine &line);
+QDataStream &operator>>(QDataStream &in, LogLine &line);
+
+#endif // DAEMONPROTOCOL_H
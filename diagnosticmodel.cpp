@@ -0,0 +1,239 @@
+#include "diagnosticmodel.h"
+
+#include <QColor>
+#include <QSet>
+
+namespace {
+
+QColor severityColor(bool error)
+{
+    return error ? QColor(Qt::red) : QColor(255, 140, 0);
+}
+
+} // namespace
+
+DiagnosticModel::DiagnosticModel(QObject *parent) : QAbstractItemModel(parent)
+{
+}
+
+// Top-level rows have internal id 0, children of group g have g + 1
+QModelIndex DiagnosticModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent)) return QModelIndex();
+    if (!parent.isValid()) return createIndex(row, column, quintptr(0));
+    return createIndex(row, column, quintptr(parent.row() + 1));
+}
+
+QModelIndex DiagnosticModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == 0) return QModelIndex();
+    return createIndex(int(child.internalId() - 1), 0, quintptr(0));
+}
+
+int DiagnosticModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return currentGrouping == Grouping::None ? int(entries.size()) : int(groups.size());
+    }
+    if (currentGrouping == Grouping::None || parent.internalId() != 0 || parent.column() != 0) return 0;
+    return int(groups.at(parent.row()).entries.size());
+}
+
+int DiagnosticModel::columnCount(const QModelIndex &) const
+{
+    return ColumnCount;
+}
+
+QVariant DiagnosticModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+
+    if (const Entry *entry = entryAt(index)) {
+        const Diagnostic &diagnostic = entry->diagnostic;
+        const bool error = diagnostic.severity == Diagnostic::Severity::Error;
+
+        if (role == Qt::ForegroundRole && index.column() == SeverityColumn) return severityColor(error);
+        if (role == Qt::ToolTipRole) return QString::fromUtf8(diagnostic.message);
+        if (role != Qt::DisplayRole) return QVariant();
+
+        switch (index.column()) {
+        case CountColumn:    return entry->count;
+        case SeverityColumn: return error ? QString("error") : QString("warning");
+        case FileColumn:     return QString::fromUtf8(diagnostic.file);
+        case LineColumn:     return diagnostic.line > 0 ? QVariant(diagnostic.line) : QVariant();
+        case FlagColumn:     return QString::fromUtf8(diagnostic.flag);
+        case MessageColumn:  return QString::fromUtf8(diagnostic.message);
+        }
+        return QVariant();
+    }
+
+    // Group row: the key sits in the column it was grouped by
+    const Group &group = groups.at(index.row());
+    if (role == Qt::ForegroundRole && index.column() == SeverityColumn) return severityColor(group.hasError);
+    if (role != Qt::DisplayRole) return QVariant();
+
+    const int keyColumn = currentGrouping == Grouping::File ? FileColumn : FlagColumn;
+    switch (index.column()) {
+    case CountColumn:    return group.count;
+    case SeverityColumn: return group.hasError ? QString("error") : QString("warning");
+    case MessageColumn:  return QString("%1 distinct").arg(group.entries.size());
+    default:
+        if (index.column() == keyColumn) return QString::fromUtf8(group.key);
+    }
+    return QVariant();
+}
+
+QVariant DiagnosticModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+
+    switch (section) {
+    case CountColumn:    return QString("Count");
+    case SeverityColumn: return QString("Severity");
+    case FileColumn:     return QString("File");
+    case LineColumn:     return QString("Line");
+    case FlagColumn:     return QString("Flag");
+    case MessageColumn:  return QString("Message");
+    }
+    return QVariant();
+}
+
+void DiagnosticModel::addLines(const LogLineBatch &lines, int firstRow)
+{
+    QSet<int> touchedGroups;
+    bool countsChanged = false;
+
+    int row = firstRow;
+    for (const LogLine &line : lines) {
+        const int id = line.diagnostic;
+        if (id >= 0 && id < int(entries.size())) {
+            // A repeat: only the counters move
+            Entry &entry = entries[id];
+            ++entry.count;
+            if (entry.group >= 0) {
+                ++groups[entry.group].count;
+                touchedGroups.insert(entry.group);
+            }
+            countsChanged = true;
+            ++occurrences;
+        } else if (id == int(entries.size())) {
+            // Ids arrive in order, so a new one is always the next entry
+            Diagnostic diagnostic;
+            if (!DiagnosticParser::parse(line.text, &diagnostic)) {
+                diagnostic.message = line.text;
+            }
+            addEntry(diagnostic, row);
+            ++occurrences;
+        }
+        ++row;
+    }
+
+    if (!countsChanged) return;
+
+    const int topRows = rowCount();
+    if (topRows > 0) {
+        emit dataChanged(index(0, CountColumn), index(topRows - 1, CountColumn));
+    }
+    for (const int group : touchedGroups) {
+        const QModelIndex parent = index(group, 0);
+        emit dataChanged(index(0, CountColumn, parent), index(rowCount(parent) - 1, CountColumn, parent));
+    }
+}
+
+void DiagnosticModel::clear()
+{
+    beginResetModel();
+    entries.clear();
+    groups.clear();
+    groupIds.clear();
+    occurrences = 0;
+    endResetModel();
+}
+
+void DiagnosticModel::setGrouping(Grouping grouping)
+{
+    if (grouping == currentGrouping) return;
+
+    beginResetModel();
+    currentGrouping = grouping;
+    groups.clear();
+    groupIds.clear();
+
+    for (int id = 0; id < entries.size(); ++id) {
+        Entry &entry = entries[id];
+        entry.group = -1;
+        if (grouping == Grouping::None) continue;
+
+        const QByteArray key = groupKey(entry.diagnostic);
+        auto it = groupIds.constFind(key);
+        if (it == groupIds.constEnd()) {
+            it = groupIds.insert(key, int(groups.size()));
+            groups.append({key, {}, 0, false});
+        }
+
+        Group &group = groups[it.value()];
+        group.entries.append(id);
+        group.count += entry.count;
+        group.hasError |= entry.diagnostic.severity == Diagnostic::Severity::Error;
+        entry.group = it.value();
+    }
+    endResetModel();
+}
+
+int DiagnosticModel::firstRow(const QModelIndex &index) const
+{
+    const Entry *entry = entryAt(index);
+    return entry ? entry->firstRow : -1;
+}
+
+QByteArray DiagnosticModel::groupKey(const Diagnostic &diagnostic) const
+{
+    if (currentGrouping == Grouping::File) return diagnostic.file;
+    return diagnostic.flag.isEmpty() ? QByteArray("(no flag)") : diagnostic.flag;
+}
+
+void DiagnosticModel::addEntry(const Diagnostic &diagnostic, int row)
+{
+    Entry entry;
+    entry.diagnostic = diagnostic;
+    entry.firstRow = row;
+    const int id = int(entries.size());
+
+    if (currentGrouping == Grouping::None) {
+        beginInsertRows(QModelIndex(), id, id);
+        entries.append(entry);
+        endInsertRows();
+        return;
+    }
+
+    const QByteArray key = groupKey(diagnostic);
+    const bool error = diagnostic.severity == Diagnostic::Severity::Error;
+    auto it = groupIds.constFind(key);
+    if (it == groupIds.constEnd()) {
+        const int group = int(groups.size());
+        entry.group = group;
+        beginInsertRows(QModelIndex(), group, group);
+        entries.append(entry);
+        groups.append({key, {id}, 1, error});
+        groupIds.insert(key, group);
+        endInsertRows();
+        return;
+    }
+
+    const int group = it.value();
+    entry.group = group;
+    const int childRow = int(groups.at(group).entries.size());
+    beginInsertRows(index(group, 0), childRow, childRow);
+    entries.append(entry);
+    groups[group].entries.append(id);
+    groups[group].count += 1;
+    groups[group].hasError |= error;
+    endInsertRows();
+}
+
+const DiagnosticModel::Entry *DiagnosticModel::entryAt(const QModelIndex &index) const
+{
+    if (currentGrouping == Grouping::None) return &entries.at(index.row());
+    if (index.internalId() == 0) return nullptr;
+    return &entries.at(groups.at(int(index.internalId() - 1)).entries.at(index.row()));
+}
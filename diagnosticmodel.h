@@ -0,0 +1,89 @@
+#ifndef DIAGNOSTICMODEL_H
+#define DIAGNOSTICMODEL_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QList>
+
+#include "diagnosticparser.h"
+#include "logline.h"
+
+// Table of distinct compiler and CMake diagnostics with occurrence counts.
+//
+// The worker has already deduplicated the diagnostics and tagged each line
+// with an id, so a repeat only bumps a counter here and only the first
+// occurrence is parsed. With a grouping set, the table becomes a two-level
+// tree: one row per file or flag with the diagnostics underneath.
+class DiagnosticModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        CountColumn,
+        SeverityColumn,
+        FileColumn,
+        LineColumn,
+        FlagColumn,
+        MessageColumn,
+        ColumnCount
+    };
+
+    enum class Grouping
+    {
+        None,
+        File,
+        Flag
+    };
+
+    explicit DiagnosticModel(QObject *parent = nullptr);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // lines are about to be appended to the log starting at firstRow
+    void addLines(const LogLineBatch &lines, int firstRow);
+    void clear();
+
+    void setGrouping(Grouping grouping);
+
+    // Log row of the diagnostic's first occurrence, -1 for a group row
+    int firstRow(const QModelIndex &index) const;
+
+    int distinctCount() const { return int(entries.size()); }
+    int totalCount() const { return occurrences; }
+
+private:
+    struct Entry
+    {
+        Diagnostic diagnostic;
+        int count = 1;
+        int firstRow = -1;
+        int group = -1;
+    };
+
+    struct Group
+    {
+        QByteArray key;
+        QList<int> entries;
+        int count = 0;
+        bool hasError = false;
+    };
+
+    QByteArray groupKey(const Diagnostic &diagnostic) const;
+    void addEntry(const Diagnostic &diagnostic, int row);
+    const Entry *entryAt(const QModelIndex &index) const;
+
+    Grouping currentGrouping = Grouping::None;
+    QList<Entry> entries;       // indexed by the worker's diagnostic id
+    QList<Group> groups;
+    QHash<QByteArray, int> groupIds;
+    int occurrences = 0;
+};
+
+#endif // DIAGNOSTICMODEL_H
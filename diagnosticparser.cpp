@@ -0,0 +1,165 @@
+#include "diagnosticparser.h"
+
+#include <string_view>
+
+namespace {
+
+std::string_view view(QByteArrayView bytes)
+{
+    return std::string_view(bytes.data(), std::size_t(bytes.size()));
+}
+
+QByteArray trimmed(std::string_view text)
+{
+    const std::size_t first = text.find_first_not_of(" \t");
+    if (first == std::string_view::npos) return QByteArray();
+    const std::size_t last = text.find_last_not_of(" \t");
+    return QByteArray(text.data() + first, qsizetype(last - first + 1));
+}
+
+bool parseNumber(std::string_view text, int *value)
+{
+    if (text.empty() || text.size() > 9) return false;
+    int number = 0;
+    for (const char c : text) {
+        if (c < '0' || c > '9') return false;
+        number = number * 10 + (c - '0');
+    }
+    *value = number;
+    return true;
+}
+
+// "path:line:col", "path:line" or a bare path or tool name
+bool parseLocation(std::string_view location, Diagnostic *diagnostic)
+{
+    const std::size_t first = location.find_first_not_of(" \t");
+    if (first == std::string_view::npos) return false;
+    location.remove_prefix(first);
+
+    int numbers[2] = {0, 0};
+    int found = 0;
+    while (found < 2) {
+        const std::size_t colon = location.rfind(':');
+        if (colon == std::string_view::npos || !parseNumber(location.substr(colon + 1), &numbers[found])) break;
+        location = location.substr(0, colon);
+        ++found;
+    }
+
+    // Without a line number, anything with spaces is prose, not a path
+    if (location.empty()) return false;
+    if (found == 0 && location.find(' ') != std::string_view::npos) return false;
+
+    diagnostic->file = QByteArray(location.data(), qsizetype(location.size()));
+    diagnostic->line = found == 2 ? numbers[1] : numbers[0];
+    diagnostic->column = found == 2 ? numbers[0] : 0;
+    return true;
+}
+
+// Splits a trailing "[-Wflag]" or "[-Wflag,-Werror]" off the message
+void parseMessage(std::string_view message, Diagnostic *diagnostic)
+{
+    const std::size_t open = message.rfind(" [-W");
+    if (open != std::string_view::npos && message.back() == ']') {
+        std::string_view flag = message.substr(open + 2, message.size() - open - 3);
+        flag = flag.substr(0, flag.find(','));
+        diagnostic->flag = QByteArray(flag.data(), qsizetype(flag.size()));
+        message = message.substr(0, open);
+    }
+    diagnostic->message = trimmed(message);
+}
+
+// "CMake Warning (dev) at path:line (command):", "CMake Error: message"
+bool parseCMake(std::string_view line, Diagnostic *diagnostic)
+{
+    const std::size_t at = line.find(" at ");
+    const std::string_view header = line.substr(0, qMin(at, line.find(':')));
+
+    if (header.find("Error") != std::string_view::npos) {
+        diagnostic->severity = Diagnostic::Severity::Error;
+    } else if (header.find("Warning") != std::string_view::npos) {
+        diagnostic->severity = Diagnostic::Severity::Warning;
+    } else {
+        return false;
+    }
+
+    // CMake's own names for the warning categories
+    if (header.find("(dev)") != std::string_view::npos) {
+        diagnostic->flag = "-Wdev";
+    } else if (header.find("Deprecation") != std::string_view::npos) {
+        diagnostic->flag = "-Wdeprecated";
+    }
+
+    if (at == std::string_view::npos) {
+        const std::size_t colon = line.find(':');
+        if (colon == std::string_view::npos) return false;
+        diagnostic->file = "CMake";
+        diagnostic->message = trimmed(line.substr(colon + 1));
+        return true;
+    }
+
+    // The message text itself follows on the next, indented lines
+    std::string_view location = line.substr(at + 4);
+    const std::size_t command = location.find(" (");
+    if (command != std::string_view::npos) {
+        std::string_view name = location.substr(command + 1);
+        if (!name.empty() && name.back() == ':') name.remove_suffix(1);
+        diagnostic->message = trimmed(name);
+        location = location.substr(0, command);
+    } else if (!location.empty() && location.back() == ':') {
+        location.remove_suffix(1);
+    }
+    return parseLocation(location, diagnostic);
+}
+
+} // namespace
+
+bool DiagnosticParser::parse(QByteArrayView line, Diagnostic *diagnostic)
+{
+    std::string_view text = view(line);
+    const std::size_t first = text.find_first_not_of(" \t");
+    if (first == std::string_view::npos) return false;
+    text.remove_prefix(first);
+
+    Diagnostic result;
+    if (text.substr(0, 6) == "CMake ") {
+        if (!parseCMake(text, &result)) return false;
+        *diagnostic = result;
+        return true;
+    }
+
+    static const struct { std::string_view marker; Diagnostic::Severity severity; } markers[] = {
+        {" warning: ", Diagnostic::Severity::Warning},
+        {" error: ", Diagnostic::Severity::Error},
+        {" fatal error: ", Diagnostic::Severity::Error},
+    };
+
+    // The location ends at the first colon that is followed by a severity
+    for (std::size_t colon = text.find(':'); colon != std::string_view::npos; colon = text.find(':', colon + 1)) {
+        const std::string_view rest = text.substr(colon + 1);
+        for (const auto &entry : markers) {
+            if (rest.substr(0, entry.marker.size()) != entry.marker) continue;
+
+            if (!parseLocation(text.substr(0, colon), &result)) return false;
+            result.severity = entry.severity;
+            parseMessage(rest.substr(entry.marker.size()), &result);
+            *diagnostic = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+int DiagnosticParser::intern(QByteArrayView line)
+{
+    Diagnostic diagnostic;
+    if (!parse(line, &diagnostic)) return -1;
+
+    // Look up without copying; only a new diagnostic allocates its key
+    const QByteArray key = QByteArray::fromRawData(line.data(), line.size());
+    const auto it = ids.constFind(key);
+    if (it != ids.constEnd()) return it.value();
+
+    const int id = int(ids.size());
+    ids.insert(QByteArray(line.data(), line.size()), id);
+    return id;
+}
@@ -0,0 +1,47 @@
+#ifndef DIAGNOSTICPARSER_H
+#define DIAGNOSTICPARSER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+
+// One compiler or CMake diagnostic, parsed from a single output line
+struct Diagnostic
+{
+    enum class Severity : quint8
+    {
+        Warning,
+        Error
+    };
+
+    Severity severity = Severity::Warning;
+    QByteArray file;        // source path, or the tool name for "clang++: error: ..."
+    int line = 0;           // 0 if the diagnostic has no location
+    int column = 0;
+    QByteArray message;
+    QByteArray flag;        // "-Wunused-variable" etc., empty if none
+};
+
+// Recognizes clang/gcc diagnostics ("file:line:col: warning: ... [-Wflag]",
+// also without column or location) and CMake message headers ("CMake Warning
+// (dev) at file:line (command):").
+//
+// intern() deduplicates by hashing the whole diagnostic line: identical
+// diagnostics get the same id, and new ids are handed out consecutively
+// from 0, so a consumer that sees ids in order can keep a plain table.
+class DiagnosticParser
+{
+public:
+    static bool parse(QByteArrayView line, Diagnostic *diagnostic);
+
+    // Returns the diagnostic's id, or -1 if the line is not a diagnostic
+    int intern(QByteArrayView line);
+    void clear() { ids.clear(); }
+
+    int count() const { return int(ids.size()); }
+
+private:
+    QHash<QByteArray, int> ids;
+};
+
+#endif // DIAGNOSTICPARSER_H
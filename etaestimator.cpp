@@ -0,0 +1,122 @@
+#include "etaestimator.h"
+
+namespace
+{
+
+// Below this share of steps done, the live rate is too noisy to use
+constexpr double MinLiveFraction = 0.02;
+
+} // namespace
+
+void EtaEstimator::start(const PhaseHistory::Traits &runTraits)
+{
+    traits = runTraits;
+    phases = {{0, QString("Startup"), 0, -1, 0}};
+    stepsDone = 0;
+    stepsTotal = 0;
+    pausedSinceUs = -1;
+    pausedUs = 0;
+}
+
+void EtaEstimator::addLines(const LogLineBatch &lines)
+{
+    if (phases.isEmpty()) return;
+
+    for (const LogLine &line : lines) {
+        // Same rule as the progress bar: only a higher milestone starts a phase
+        if (line.progress > phases.last().milestone) {
+            // Output read just before a pause can still start a phase
+            if (isPaused()) {
+                const qint64 splitUs = qMax(line.timestampUs, pausedSinceUs);
+                resume(splitUs);
+                pausedSinceUs = splitUs;
+            }
+            phases.last().endUs = line.timestampUs;
+            phases.append({line.progress, QString::fromUtf8(line.text).trimmed(), line.timestampUs, -1, 0});
+            stepsDone = 0;
+            stepsTotal = 0;
+        }
+    }
+}
+
+void EtaEstimator::setSteps(int done, int total)
+{
+    stepsDone = done;
+    stepsTotal = total;
+}
+
+void EtaEstimator::pause(qint64 nowUs)
+{
+    if (phases.isEmpty() || isPaused()) return;
+    pausedSinceUs = nowUs;
+}
+
+void EtaEstimator::resume(qint64 nowUs)
+{
+    if (phases.isEmpty() || !isPaused()) return;
+
+    // Charged to the phase that is current now
+    const qint64 interval = qMax<qint64>(0, nowUs - pausedSinceUs);
+    phases.last().pausedUs += interval;
+    pausedUs += interval;
+    pausedSinceUs = -1;
+}
+
+void EtaEstimator::finish(bool completed, qint64 timestampUs, PhaseHistory *history)
+{
+    if (phases.isEmpty()) return;
+
+    resume(timestampUs);
+    if (completed) {
+        phases.last().endUs = timestampUs;
+    }
+    for (const Phase &phase : phases) {
+        if (phase.endUs >= phase.startUs) {
+            const double seconds = qMax<qint64>(0, phase.endUs - phase.startUs - phase.pausedUs) / 1e6;
+            history->record(phase.milestone, phase.title, seconds, phase.pausedUs / 1e6, traits);
+        }
+    }
+    phases.clear();
+}
+
+double EtaEstimator::phaseRemaining(const PhaseHistory &history, qint64 nowUs) const
+{
+    if (phases.isEmpty()) return -1;
+
+    // Frozen at the moment of the pause
+    const Phase &phase = phases.last();
+    const qint64 runningUntilUs = isPaused() ? pausedSinceUs : nowUs;
+    const double elapsed = qMax<qint64>(0, runningUntilUs - phase.startUs - phase.pausedUs) / 1e6;
+    const double expected = history.predict(phase.milestone, traits);
+    const double fraction = stepsTotal > 0 ? double(stepsDone) / stepsTotal : 0;
+
+    double projected = expected;
+    if (fraction >= MinLiveFraction) {
+        const double live = elapsed / fraction;
+        projected = expected < 0 ? live : fraction * live + (1 - fraction) * expected;
+    }
+    if (projected < 0) return -1;
+
+    // Running late on history alone: no better guess than "about done"
+    return qMax(0.0, projected - elapsed);
+}
+
+double EtaEstimator::totalRemaining(const PhaseHistory &history, qint64 nowUs) const
+{
+    const double current = phaseRemaining(history, nowUs);
+    if (current < 0) return -1;
+
+    return current + history.predictAfter(phases.last().milestone, traits);
+}
+
+QString EtaEstimator::formatDuration(double seconds)
+{
+    const qint64 total = qint64(seconds + 0.5);
+    if (total >= 3600) {
+        return QString("%1h %2m").arg(total / 3600).arg(total / 60 % 60, 2, 10, QLatin1Char('0'));
+    }
+    if (total >= 60) {
+        return QString("%1m").arg((total + 30) / 60);
+    }
+    return QString("%1s").arg(total);
+}
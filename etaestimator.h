@@ -0,0 +1,60 @@
+#ifndef ETAESTIMATOR_H
+#define ETAESTIMATOR_H
+
+#include <QList>
+#include <QString>
+
+#include "logline.h"
+#include "phasehistory.h"
+
+// Predicts the time left in the current phase and in the whole run.
+//
+// Phases are split at progress milestones, the same way LogModel does, and
+// timed with the lines' own timestamps. The current phase is estimated from
+// its recorded history and, once ninja counters appear, from the live rate
+// of finished steps; the live rate gets more weight as more steps are done.
+// Paused time does not count towards a phase, and while paused the
+// estimate stands still.
+// The remaining phases are predicted from history alone. finish() adds
+// every phase that ran to completion to the history.
+class EtaEstimator
+{
+public:
+    void start(const PhaseHistory::Traits &traits);
+    void addLines(const LogLineBatch &lines);
+    void setSteps(int done, int total);
+    void pause(qint64 nowUs);
+    void resume(qint64 nowUs);
+
+    bool isPaused() const { return pausedSinceUs >= 0; }
+    qint64 totalPausedUs() const { return pausedUs; }
+
+    // A run that failed or was stopped only records the phases it completed
+    void finish(bool completed, qint64 timestampUs, PhaseHistory *history);
+
+    // Seconds left, or -1 when there is nothing to base a guess on
+    double phaseRemaining(const PhaseHistory &history, qint64 nowUs) const;
+    double totalRemaining(const PhaseHistory &history, qint64 nowUs) const;
+
+    // "1h 05m", "12m" or "40s"
+    static QString formatDuration(double seconds);
+
+private:
+    struct Phase
+    {
+        int milestone = 0;
+        QString title;
+        qint64 startUs = 0;
+        qint64 endUs = -1;
+        qint64 pausedUs = 0;
+    };
+
+    PhaseHistory::Traits traits;
+    QList<Phase> phases;
+    int stepsDone = 0;
+    int stepsTotal = 0;
+    qint64 pausedSinceUs = -1;
+    qint64 pausedUs = 0;
+};
+
+#endif // ETAESTIMATOR_H
@@ -0,0 +1,457 @@
+#include "headlessrunner.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QThread>
+#include <QTimer>
+
+#include <csignal>
+#include <cstdio>
+
+#if defined(Q_OS_UNIX)
+#include <sys/ioctl.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <io.h>
+#endif
+
+#include "installcheckpoint.h"
+#include "logwriter.h"
+
+namespace
+{
+
+constexpr int SummaryVersion = 1;
+constexpr int DefaultTerminalWidth = 80;
+
+// Set by the signal handler, picked up by the next tick
+volatile std::sig_atomic_t interruptRequested = 0;
+
+void requestInterrupt(int)
+{
+    interruptRequested = 1;
+}
+
+bool isTerminal(FILE *stream)
+{
+#if defined(Q_OS_UNIX)
+    return ::isatty(::fileno(stream));
+#elif defined(Q_OS_WIN)
+    return ::_isatty(::_fileno(stream));
+#else
+    Q_UNUSED(stream);
+    return false;
+#endif
+}
+
+int terminalWidth()
+{
+#if defined(Q_OS_UNIX)
+    winsize size{};
+    if (::ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) return size.ws_col;
+#endif
+    return DefaultTerminalWidth;
+}
+
+} // namespace
+
+HeadlessRunner::HeadlessRunner(const Options &runOptions, QObject *parent)
+    : QObject(parent)
+    , options(runOptions)
+    , lineQueue(LineQueueCapacity)
+    , tickTimer(new QTimer(this))
+{
+    interactive = isTerminal(stdout);
+
+    // Same threads as the GUI: the worker reads and classifies, the writer saves
+    workerThread = new QThread(this);
+    worker = new InstallWorker(&lineQueue, &sessionClock);
+    worker->moveToThread(workerThread);
+    connect(worker, &InstallWorker::linesReady, this, &HeadlessRunner::drainLines);
+    connect(worker, &InstallWorker::progressChanged, this, &HeadlessRunner::updateProgress);
+    connect(worker, &InstallWorker::failedToStart, this, &HeadlessRunner::processFailedToStart);
+    connect(worker, &InstallWorker::finished, this, &HeadlessRunner::processFinished);
+    workerThread->start();
+
+    writerThread = new QThread(this);
+    logWriter = new LogWriter();
+    logWriter->moveToThread(writerThread);
+    connect(logWriter, &LogWriter::failed, this, [this](const QString &errorString) {
+        appendMessage(QString("Session log disabled: %1").arg(errorString), LineClass::Warning);
+    });
+    writerThread->start();
+
+    tickTimer->setInterval(TickIntervalMs);
+    connect(tickTimer, &QTimer::timeout, this, &HeadlessRunner::tick);
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    QMetaObject::invokeMethod(worker, &InstallWorker::shutdown, Qt::BlockingQueuedConnection);
+    workerThread->quit();
+    workerThread->wait();
+    delete worker;
+
+    QMetaObject::invokeMethod(logWriter, &LogWriter::close, Qt::BlockingQueuedConnection);
+    writerThread->quit();
+    writerThread->wait();
+    delete logWriter;
+}
+
+int HeadlessRunner::run(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs install.sh without a window and exits with its exit code.");
+    parser.addHelpOption();
+    parser.addOption({"headless", "Run without a window."});
+    parser.addOption({"qml", "Build QML/QtQuick support."});
+    parser.addOption({"resume", "Resume at the phase the last run failed in."});
+    parser.addOption({"log-dir", "Directory for the session log.", "dir", LogWriter::defaultDirectory()});
+    parser.addOption({"summary", "Path of the JSON summary (default: next to the session log).", "file"});
+    parser.addPositionalArgument("script", "Path to install.sh.");
+
+    if (!parser.parse(app.arguments())) {
+        std::fprintf(stderr, "%s\n\n%s", qPrintable(parser.errorText()), qPrintable(parser.helpText()));
+        return ExitUsage;
+    }
+    if (parser.isSet("help")) {
+        std::fputs(qPrintable(parser.helpText()), stdout);
+        return 0;
+    }
+    if (parser.positionalArguments().size() != 1) {
+        std::fprintf(stderr, "Expected exactly one script.\n\n%s", qPrintable(parser.helpText()));
+        return ExitUsage;
+    }
+
+    Options options;
+    options.scriptPath = parser.positionalArguments().first();
+    options.logDirectory = parser.value("log-dir");
+    options.summaryPath = parser.value("summary");
+    options.qml = parser.isSet("qml");
+    if (!QFileInfo(options.scriptPath).isFile()) {
+        std::fprintf(stderr, "Script not found: %s\n", qPrintable(options.scriptPath));
+        return ExitUsage;
+    }
+    if (parser.isSet("resume")) {
+        InstallCheckpoint checkpoint;
+        QString checkpointError;
+        if (!checkpoint.load(InstallCheckpoint::defaultPath(), &checkpointError)) {
+            std::fprintf(stderr, "Cannot read the checkpoint: %s\n", qPrintable(checkpointError));
+            return ExitUsage;
+        }
+        if (checkpoint.failedPhase().isEmpty()) {
+            std::fprintf(stderr, "The last run did not fail in a phase; nothing to resume.\n");
+            return ExitUsage;
+        }
+        options.resumeFrom = checkpoint.failedPhase();
+    }
+
+    // The script leads its own process group, so a Ctrl+C has to be passed on
+    std::signal(SIGINT, requestInterrupt);
+    std::signal(SIGTERM, requestInterrupt);
+
+    HeadlessRunner runner(options);
+    QMetaObject::invokeMethod(&runner, &HeadlessRunner::start, Qt::QueuedConnection);
+    return app.exec();
+}
+
+void HeadlessRunner::start()
+{
+    sessionClock.restart();
+    startedAt = QDateTime::currentDateTime();
+
+    logPath = LogWriter::sessionPath(options.logDirectory);
+    QMetaObject::invokeMethod(logWriter, [writer = logWriter, path = logPath]() { writer->open(path); });
+
+    const int parallelJobs = qEnvironmentVariableIsSet("PARALLEL_JOBS")
+        ? qMax(1, qEnvironmentVariableIntValue("PARALLEL_JOBS")) : DefaultParallelJobs;
+    QString historyError;
+    if (!phaseHistory.load(PhaseHistory::defaultPath(), &historyError)) {
+        appendMessage(QString("Ignoring phase history: %1").arg(historyError), LineClass::Warning);
+    }
+    eta.start({QThread::idealThreadCount(), parallelJobs, options.qml});
+    phases = {{0, QString("Startup"), 0}};
+
+    appendMessage("=== Starting Qt6 Installation ===", LineClass::Info);
+    appendMessage(QString("Script: %1").arg(options.scriptPath), LineClass::Detail);
+    appendMessage(QString("QML Support: %1").arg(options.qml ? "Yes" : "No"), LineClass::Detail);
+    if (!options.resumeFrom.isEmpty()) {
+        appendMessage(QString("Resuming from: %1").arg(options.resumeFrom), LineClass::Detail);
+    }
+    appendMessage(QString("Session log: %1").arg(QDir::toNativeSeparators(logPath)), LineClass::Detail);
+
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("BUILD_QML", options.qml ? "y" : "n");
+    env.insert("PARALLEL_JOBS", QString::number(parallelJobs));
+    if (!options.resumeFrom.isEmpty()) env.insert("RESUME_FROM", options.resumeFrom);
+
+    const QStringList arguments{options.scriptPath};
+    QMetaObject::invokeMethod(worker, [this, arguments, env]() {
+        worker->start("/bin/bash", arguments, env);
+    });
+    tickTimer->start();
+}
+
+void HeadlessRunner::drainLines()
+{
+    // No frame budget here; there is nothing else for this thread to do
+    worker->acknowledgeLines();
+
+    LogLineBatch batch;
+    while (lineQueue.tryPop(batch)) {
+        processLines(batch);
+    }
+}
+
+void HeadlessRunner::updateProgress(double newPercent, int done, int total)
+{
+    eta.setSteps(done, total);
+    percent = qMax(percent, newPercent);
+    stepsDone = done;
+    stepsTotal = total;
+}
+
+void HeadlessRunner::tick()
+{
+    if (interruptRequested && !stopRequested) {
+        // The worker reports back through processFinished()
+        stopRequested = true;
+        appendMessage("=== Stopping installation... ===", LineClass::Error);
+        QMetaObject::invokeMethod(worker, &InstallWorker::stop);
+    }
+    drawProgress();
+}
+
+void HeadlessRunner::processFailedToStart(const QString &errorString)
+{
+    appendMessage(QString("ERROR: Failed to start installation process! (%1)").arg(errorString), LineClass::Error);
+    eta.finish(false, sessionClock.elapsedUs(), &phaseHistory);
+    finishRun(ExitFailed, "failed_to_start");
+}
+
+void HeadlessRunner::processFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    // The worker only emits finished() once its last batch is in the queue
+    const qint64 finishedUs = sessionClock.elapsedUs();
+    drainLines();
+
+    const bool completed = !stopRequested && exitStatus == QProcess::NormalExit && exitCode == 0;
+    eta.finish(completed, finishedUs, &phaseHistory);
+
+    // A resumed phase only shows its remainder, which would skew the history
+    QString historyError;
+    if (options.resumeFrom.isEmpty() && !phaseHistory.save(PhaseHistory::defaultPath(), &historyError)) {
+        appendMessage(QString("Phase history not saved: %1").arg(historyError), LineClass::Warning);
+    }
+
+    if (stopRequested) {
+        appendMessage("Installation stopped.", LineClass::Error);
+        finishRun(ExitInterrupted, "stopped");
+    } else if (exitStatus == QProcess::CrashExit) {
+        appendMessage("=== Process crashed ===", LineClass::Error);
+        finishRun(ExitFailed, "crashed");
+    } else if (exitCode == 0) {
+        appendMessage("=== Installation completed successfully! ===", LineClass::Success);
+        finishRun(0, "success");
+    } else {
+        appendMessage(QString("=== Installation failed with exit code %1 ===").arg(exitCode), LineClass::Error);
+        finishRun(exitCode, "failed");
+    }
+}
+
+void HeadlessRunner::appendMessage(const QString &text, LineClass lineClass)
+{
+    // Script lines stamped before this message go to the log ahead of it
+    drainLines();
+
+    LogLine line{text.toUtf8(), lineClass};
+    line.channel = LogChannel::Installer;
+    sessionClock.stamp(&line, sessionClock.elapsedUs());
+    processLines({line});
+
+    printLine(text, lineClass == LineClass::Error || lineClass == LineClass::Warning);
+}
+
+void HeadlessRunner::processLines(const LogLineBatch &lines)
+{
+    // The batch is implicitly shared, so handing it to the writer copies nothing
+    QMetaObject::invokeMethod(logWriter, [writer = logWriter, lines]() { writer->append(lines); });
+    eta.addLines(lines);
+
+    for (const LogLine &line : lines) {
+        ++lineCount;
+        switch (line.lineClass) {
+        case LineClass::Error:   ++errorLines; break;
+        case LineClass::Warning: ++warningLines; break;
+        case LineClass::Stderr:  ++stderrLines; break;
+        default: break;
+        }
+
+        // Same rule as the progress bar: only a higher milestone starts a phase
+        if (line.progress > phases.last().milestone) {
+            phases.append({line.progress, QString::fromUtf8(line.text).trimmed(), line.timestampUs});
+            printLine(QString("[%1] %2").arg(SessionClock::formatElapsed(line.timestampUs).left(8), phases.last().title));
+        }
+
+        if (line.diagnostic >= 0) {
+            ++diagnosticTotal;
+            if (line.diagnostic >= diagnosticsSeen) {
+                diagnosticsSeen = line.diagnostic + 1;
+                Diagnostic diagnostic;
+                if (DiagnosticParser::parse(line.text, &diagnostic) && diagnostic.severity == Diagnostic::Severity::Error) {
+                    ++distinctErrors;
+                    if (errorDiagnostics.size() < MaxSummaryDiagnostics) {
+                        errorDiagnostics.append(QString::fromUtf8(line.text));
+                    }
+                } else {
+                    ++distinctWarnings;
+                }
+            }
+        }
+
+        // Our own messages are printed by appendMessage()
+        if (line.lineClass == LineClass::Error && line.channel != LogChannel::Installer) {
+            if (echoedErrors < MaxEchoedErrors) {
+                printLine(QString::fromUtf8(line.text), true);
+            } else if (echoedErrors == MaxEchoedErrors) {
+                printLine("(further errors are only in the session log)", true);
+            }
+            ++echoedErrors;
+        }
+    }
+}
+
+void HeadlessRunner::finishRun(int exitCode, const QString &result)
+{
+    finished = true;
+    tickTimer->stop();
+    clearProgress();
+    const qint64 finishedUs = sessionClock.elapsedUs();
+
+    // Everything is on disk before the summary points at it
+    QMetaObject::invokeMethod(logWriter, &LogWriter::close, Qt::BlockingQueuedConnection);
+
+    QString errorString;
+    if (!writeSummary(exitCode, result, finishedUs, &errorString)) {
+        printLine(QString("Summary not written: %1: %2").arg(summaryPath(), errorString), true);
+    }
+
+    printLine(QString("Took %1; %2 error and %3 warning lines, %4 distinct compiler errors, %5 distinct warnings")
+        .arg(EtaEstimator::formatDuration(finishedUs / 1e6))
+        .arg(errorLines).arg(warningLines).arg(distinctErrors).arg(distinctWarnings));
+    printLine(QString("Summary: %1").arg(QDir::toNativeSeparators(summaryPath())));
+
+    QCoreApplication::exit(exitCode);
+}
+
+bool HeadlessRunner::writeSummary(int exitCode, const QString &result, qint64 finishedUs, QString *errorString) const
+{
+    QJsonArray phaseArray;
+    for (qsizetype i = 0; i < phases.size(); ++i) {
+        const Phase &phase = phases.at(i);
+        const qint64 endUs = i + 1 < phases.size() ? phases.at(i + 1).startUs : finishedUs;
+        phaseArray.append(QJsonObject{
+            {"milestone", phase.milestone},
+            {"title", phase.title},
+            {"start", phase.startUs / 1e6},
+            {"seconds", (endUs - phase.startUs) / 1e6},
+        });
+    }
+
+    const QJsonObject root{
+        {"version", SummaryVersion},
+        {"script", options.scriptPath},
+        {"qml", options.qml},
+        {"resumedFrom", options.resumeFrom},
+        {"started", startedAt.toString(Qt::ISODate)},
+        {"seconds", finishedUs / 1e6},
+        {"result", result},
+        {"exitCode", exitCode},
+        {"progress", result == "success" ? 100.0 : percent},
+        {"log", logPath},
+        {"phases", phaseArray},
+        {"lines", QJsonObject{
+            {"total", lineCount},
+            {"errors", errorLines},
+            {"warnings", warningLines},
+            {"stderr", stderrLines},
+        }},
+        {"diagnostics", QJsonObject{
+            {"errors", distinctErrors},
+            {"warnings", distinctWarnings},
+            {"total", diagnosticTotal},
+            {"firstErrors", QJsonArray::fromStringList(errorDiagnostics)},
+        }},
+    };
+
+    const QString path = summaryPath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(QJsonDocument(root).toJson()) < 0
+        || !file.commit()) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QString HeadlessRunner::summaryPath() const
+{
+    if (!options.summaryPath.isEmpty()) return options.summaryPath;
+
+    const QFileInfo logInfo(logPath);
+    return logInfo.path() + '/' + logInfo.completeBaseName() + ".summary.json";
+}
+
+void HeadlessRunner::printLine(const QString &text, bool toStderr)
+{
+    clearProgress();
+    FILE *stream = toStderr ? stderr : stdout;
+    std::fputs(text.toUtf8().constData(), stream);
+    std::fputc('\n', stream);
+    std::fflush(stream);
+    drawProgress();
+}
+
+void HeadlessRunner::drawProgress()
+{
+    if (!interactive || finished || phases.isEmpty()) return;
+
+    const qint64 nowUs = sessionClock.elapsedUs();
+    QString text = QString("[%1%] %2 %3")
+        .arg(percent, 5, 'f', 1)
+        .arg(SessionClock::formatElapsed(nowUs).left(8), phases.last().title);
+    if (stepsTotal > 0) {
+        text += QString(" (%1/%2)").arg(stepsDone).arg(stepsTotal);
+    }
+    const double phaseLeft = eta.phaseRemaining(phaseHistory, nowUs);
+    if (phaseLeft >= 0) {
+        text += QString(" - phase %1 left, %2 in total")
+            .arg(EtaEstimator::formatDuration(phaseLeft),
+                 EtaEstimator::formatDuration(eta.totalRemaining(phaseHistory, nowUs)));
+    }
+
+    // One column short, so the cursor never wraps to a new line
+    const QByteArray line = "\r" + text.left(terminalWidth() - 1).toUtf8() + "\033[K";
+    std::fwrite(line.constData(), 1, size_t(line.size()), stdout);
+    std::fflush(stdout);
+    progressShown = true;
+}
+
+void HeadlessRunner::clearProgress()
+{
+    if (!progressShown) return;
+
+    std::fputs("\r\033[K", stdout);
+    std::fflush(stdout);
+    progressShown = false;
+}
@@ -0,0 +1,122 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QDateTime>
+#include <QList>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+
+#include "etaestimator.h"
+#include "installworker.h"
+#include "phasehistory.h"
+#include "sessionclock.h"
+
+class LogWriter;
+class QThread;
+class QTimer;
+
+// Runs install.sh without a window, for CI and remote build hosts.
+//
+// Uses the same engine as the GUI: InstallWorker on its own thread, the
+// line queue, LogWriter and the ETA with its phase history. Nothing from
+// QtWidgets is created, so it works without a display. On a terminal a
+// single progress line is redrawn in place; otherwise only phase changes
+// are printed. Error lines from the script are echoed either way. When the
+// script ends, "<log>.summary.json" is written next to the session log and
+// the process exits with the script's exit code. SIGINT and SIGTERM stop
+// the build the same way the Stop button does. --resume starts over at the
+// phase the last run failed in.
+class HeadlessRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options
+    {
+        QString scriptPath;
+        QString logDirectory;
+        QString summaryPath;    // empty: next to the session log
+        QString resumeFrom;     // phase to resume at, see InstallCheckpoint
+        bool qml = false;
+    };
+
+    // Exit codes of our own, beyond those the script returns
+    static constexpr int ExitFailed = 1;
+    static constexpr int ExitUsage = 2;
+    static constexpr int ExitInterrupted = 130;
+
+    explicit HeadlessRunner(const Options &options, QObject *parent = nullptr);
+    ~HeadlessRunner();
+
+    // Parses the command line and runs to completion on a QCoreApplication
+    static int run(int argc, char *argv[]);
+
+    void start();
+
+private slots:
+    void drainLines();
+    void updateProgress(double percent, int stepsDone, int stepsTotal);
+    void tick();
+    void processFailedToStart(const QString &errorString);
+    void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    struct Phase
+    {
+        int milestone = 0;
+        QString title;
+        qint64 startUs = 0;
+    };
+
+    void appendMessage(const QString &text, LineClass lineClass);
+    void processLines(const LogLineBatch &lines);
+    void finishRun(int exitCode, const QString &result);
+    bool writeSummary(int exitCode, const QString &result, qint64 finishedUs, QString *errorString) const;
+    QString summaryPath() const;
+
+    // Terminal output
+    void printLine(const QString &text, bool toStderr = false);
+    void drawProgress();
+    void clearProgress();
+
+    static constexpr int TickIntervalMs = 250;
+    static constexpr std::size_t LineQueueCapacity = 1024;
+    static constexpr int DefaultParallelJobs = 4;   // install.sh's own default
+    static constexpr int MaxEchoedErrors = 50;
+    static constexpr int MaxSummaryDiagnostics = 20;
+
+    Options options;
+    LogBatchQueue lineQueue;
+    SessionClock sessionClock;
+    QThread *workerThread;
+    InstallWorker *worker;
+    QThread *writerThread;
+    LogWriter *logWriter;
+    QTimer *tickTimer;
+    PhaseHistory phaseHistory;
+    EtaEstimator eta;
+    QDateTime startedAt;
+    QString logPath;
+    QList<Phase> phases;
+    QStringList errorDiagnostics;       // first MaxSummaryDiagnostics distinct errors
+    double percent = 0;
+    int stepsDone = 0;
+    int stepsTotal = 0;
+    qint64 lineCount = 0;
+    qint64 errorLines = 0;
+    qint64 warningLines = 0;
+    qint64 stderrLines = 0;
+    int distinctErrors = 0;
+    int distinctWarnings = 0;
+    int diagnosticsSeen = 0;            // ids arrive in order, from 0
+    qint64 diagnosticTotal = 0;
+    int echoedErrors = 0;
+    bool interactive = false;           // stdout is a terminal
+    bool progressShown = false;
+    bool stopRequested = false;
+    bool finished = false;
+};
+
+#endif // HEADLESSRUNNER_H
@@ -1,5 +1,6 @@
 #!/bin/bash
 set -e  # Exit on error
+set -o pipefail  # ... including any command in a pipeline
 
 # Qt6 Cross-Compilation Setup Script for macOS Sequoia
 # Builds Qt6 natively for macOS and cross-compiles for Windows ARM64
@@ -24,7 +25,11 @@ BUILD_WIN_DIR="$HOME_DIR/qt6-build-winarm64"
 INSTALL_HOST_DIR="$HOME_DIR/qt6-host-macos"
 INSTALL_WIN_DIR="$HOME_DIR/qt6-winarm64"
 LLVM_MINGW_DIR="$HOME_DIR/llvm-mingw"
-PARALLEL_JOBS=4
+PARALLEL_JOBS="${PARALLEL_JOBS:-4}"
+CHECKPOINT_FILE="${INSTALLER_CHECKPOINT:-$HOME_DIR/.qt6-installer-checkpoint}"
+
+# Phase to resume a failed run from; see run_phase
+RESUME_FROM="${RESUME_FROM:-}"
 
 # Get BUILD_QML from environment or default to 'n'
 BUILD_QML="${BUILD_QML:-n}"
@@ -54,6 +59,119 @@ echo_verbose() {
     fi
 }
 
+# Runs a build command with its output going straight to ours, stderr
+# included, and returns its exit status. No per-line shell loop: a Qt build
+# logs hundreds of MB, and the reader is the GUI or a terminal anyway.
+run_verbose() {
+    if [ "$VERBOSE" -eq 1 ]; then
+        "$@" 2>&1
+    else
+        "$@" > /dev/null 2>&1
+    fi
+}
+
+# Machine-readable progress for the GUI: one JSON object per line on the
+# descriptor named by INSTALLER_EVENT_FD. Does nothing when run by hand.
+emit_event() {
+    if [ -n "${INSTALLER_EVENT_FD:-}" ]; then
+        printf '{"event":"%s"%s}\n' "$1" "$2" >&"$INSTALLER_EVENT_FD"
+    fi
+}
+
+# phase_start <id> <percent> <title>
+phase_start() {
+    emit_event phase_start ",\"phase\":\"$1\",\"progress\":$2,\"title\":\"$3\""
+}
+
+phase_end() {
+    emit_event phase_end ",\"phase\":\"$1\""
+}
+
+skipped() {
+    emit_event skipped ",\"component\":\"$1\""
+}
+
+# Phases that can be resumed, in the order they run
+RESUMABLE_PHASES=(llvm_mingw qt_source host_configure host_build host_install
+                  windows_configure windows_build windows_install qml test_app)
+CURRENT_PHASE=""
+CURRENT_PHASE_TITLE=""
+
+# Everything that decides what the phases produce; a change invalidates the checkpoint
+config_hash() {
+    printf '%s\n' "$QT_VERSION" "$LLVM_MINGW_VERSION" "$BUILD_QML" "$QT_SRC_DIR" "$BUILD_HOST_DIR" \
+        "$BUILD_WIN_DIR" "$INSTALL_HOST_DIR" "$INSTALL_WIN_DIR" "$LLVM_MINGW_DIR" | cksum | cut -d' ' -f1
+}
+CONFIG_HASH="$(config_hash)"
+
+# Records phases as finished with the current configuration
+checkpoint_done() {
+    local phase
+    for phase in "$@"; do
+        echo "done $phase $CONFIG_HASH" >> "$CHECKPOINT_FILE"
+    done
+}
+
+# True if every phase before $1 finished with the current configuration
+can_resume_from() {
+    local phase
+    [ -f "$CHECKPOINT_FILE" ] || return 1
+    for phase in "${RESUMABLE_PHASES[@]}"; do
+        [ "$phase" = "$1" ] && return 0
+        grep -qx "done $phase $CONFIG_HASH" "$CHECKPOINT_FILE" || return 1
+    done
+    return 1
+}
+
+# A resumed run keeps the earlier phases' records; any other run starts a new file
+init_checkpoint() {
+    if [ -n "$RESUME_FROM" ]; then
+        if can_resume_from "$RESUME_FROM"; then
+            echo_info "Resuming from phase $RESUME_FROM; earlier phases are checkpointed"
+            { grep -v '^failed ' "$CHECKPOINT_FILE" || true; } > "$CHECKPOINT_FILE.tmp"
+            mv "$CHECKPOINT_FILE.tmp" "$CHECKPOINT_FILE"
+            return
+        fi
+        echo_warning "Cannot resume from $RESUME_FROM: earlier phases are not checkpointed for this configuration"
+        echo_warning "Running all phases"
+        RESUME_FROM=""
+    fi
+    printf '# qt6-installer checkpoint\nconfig %s\n' "$CONFIG_HASH" > "$CHECKPOINT_FILE"
+}
+
+# run_phase <id> <percent> <title> <function>
+# Runs one phase and checkpoints it. While resuming, phases before
+# RESUME_FROM are skipped without running any of their checks.
+run_phase() {
+    if [ -n "$RESUME_FROM" ]; then
+        if [ "$1" != "$RESUME_FROM" ]; then
+            echo_info "Skipping $3 (finished before)"
+            return
+        fi
+        RESUME_FROM=""
+    fi
+    CURRENT_PHASE=$1
+    CURRENT_PHASE_TITLE=$3
+    phase_start "$1" "$2" "$3"
+    "$4"
+    phase_end "$1"
+    checkpoint_done "$1"
+    CURRENT_PHASE=""
+}
+
+# Leaving inside a phase means it failed or was stopped; record it, so the
+# GUI can offer to resume there. A fatal signal runs this with $? still 0.
+on_exit() {
+    if [ -n "$CURRENT_PHASE" ]; then
+        echo "failed $CURRENT_PHASE $CONFIG_HASH $CURRENT_PHASE_TITLE" >> "$CHECKPOINT_FILE"
+    fi
+}
+
+# True if version $1 is at least $2
+version_at_least() {
+    [ "$(printf '%s\n%s\n' "$2" "$1" | sort -V | head -n1)" = "$2" ]
+}
+
 # Check if component is installed
 is_installed() {
     local component=$1
@@ -104,12 +222,36 @@ check_prerequisites() {
     fi
     echo_verbose "  ✓ Git found: $(git --version)"
     
+    # Every configure uses the same generator, so one build tool runs all the
+    # builds and the jobserver check below holds for each of them
     if command -v ninja &> /dev/null; then
         echo_verbose "  ✓ Ninja found: $(ninja --version)"
         USE_NINJA=1
+        CMAKE_GENERATOR_ARGS=(-G Ninja)
     else
         echo_verbose "  ℹ Ninja not found, using make (slower)"
         USE_NINJA=0
+        CMAKE_GENERATOR_ARGS=(-G "Unix Makefiles")
+    fi
+    
+    # The GUI's jobserver (MAKEFLAGS) sizes the builds when the build tool can
+    # use a FIFO jobserver: ninja 1.13 or make 4.4 and later
+    BUILD_JOBS_ARGS=(--parallel "$PARALLEL_JOBS")
+    if [ -n "${INSTALLER_JOBSERVER:-}" ]; then
+        if [ "$USE_NINJA" -eq 1 ]; then
+            BUILD_TOOL_VERSION="$(ninja --version)"
+            JOBSERVER_MIN_VERSION="1.13"
+        else
+            BUILD_TOOL_VERSION="$(make --version | head -n1 | awk '{print $NF}')"
+            JOBSERVER_MIN_VERSION="4.4"
+        fi
+        if version_at_least "$BUILD_TOOL_VERSION" "$JOBSERVER_MIN_VERSION"; then
+            BUILD_JOBS_ARGS=()
+            echo_verbose "  ✓ Build jobs managed by the installer's jobserver"
+        else
+            unset MAKEFLAGS
+            echo_verbose "  ℹ Build tool $BUILD_TOOL_VERSION predates FIFO jobservers, using $PARALLEL_JOBS jobs"
+        fi
     fi
     
     echo_success "Prerequisites check passed"
@@ -120,6 +262,7 @@ setup_llvm_mingw() {
     echo_info "Setting up llvm-mingw..."
     
     if is_installed "llvm-mingw"; then
+        skipped llvm-mingw
         echo_success "llvm-mingw already installed at $LLVM_MINGW_DIR"
         echo_verbose "  Compiler: $LLVM_MINGW_DIR/bin/aarch64-w64-mingw32-clang++"
         return
@@ -145,11 +288,18 @@ setup_llvm_mingw() {
     $LLVM_MINGW_DIR/bin/aarch64-w64-mingw32-clang++ --version | head -n1
 }
 
+# llvm-mingw and the CMake toolchain file that points at it
+setup_toolchain() {
+    setup_llvm_mingw
+    create_toolchain_file
+}
+
 # Create CMake toolchain file
 create_toolchain_file() {
     echo_info "Creating CMake toolchain file..."
     
     if is_installed "toolchain"; then
+        skipped toolchain
         echo_success "Toolchain file already exists at $HOME_DIR/llvm-mingw-toolchain.cmake"
         return
     fi
@@ -181,6 +331,7 @@ download_qt6_source() {
     echo_info "Downloading Qt6 source code..."
     
     if is_installed "qt6-source"; then
+        skipped qt6-source
         echo_success "Qt6 source already exists at $QT_SRC_DIR"
         echo_verbose "  Qt version branch: $(cd $QT_SRC_DIR && git branch --show-current)"
         return
@@ -211,12 +362,20 @@ download_qt6_source() {
 build_qt6_host() {
     echo_info "Building Qt6 host tools for macOS..."
     
-    if is_installed "qt6-host"; then
+    if [ -z "$RESUME_FROM" ] && is_installed "qt6-host"; then
+        skipped qt6-host
+        checkpoint_done host_configure host_build host_install
         echo_success "Qt6 host tools already built at $INSTALL_HOST_DIR"
         echo_verbose "  moc version: $($INSTALL_HOST_DIR/libexec/moc -v 2>&1 | head -n1)"
         return
     fi
     
+    run_phase host_configure 20 "Configuring Qt6 host" configure_qt6_host
+    run_phase host_build 30 "Building Qt6 host" compile_qt6_host
+    run_phase host_install 50 "Installing Qt6 host" install_qt6_host
+}
+
+configure_qt6_host() {
     mkdir -p "$BUILD_HOST_DIR"
     cd "$BUILD_HOST_DIR"
     
@@ -226,33 +385,29 @@ build_qt6_host() {
     echo_verbose "  Build type: Release"
     echo_verbose "  Parallel jobs: $PARALLEL_JOBS"
     
-    if [ "$USE_NINJA" -eq 1 ]; then
-        cmake "$QT_SRC_DIR" \
-            -DCMAKE_BUILD_TYPE=Release \
-            -DCMAKE_INSTALL_PREFIX="$INSTALL_HOST_DIR" \
-            -DQT_BUILD_EXAMPLES=OFF \
-            -DQT_BUILD_TESTS=OFF \
-            -DQT_FORCE_BUILD_TOOLS=ON \
-            -GNinja
-    else
-        cmake "$QT_SRC_DIR" \
-            -DCMAKE_BUILD_TYPE=Release \
-            -DCMAKE_INSTALL_PREFIX="$INSTALL_HOST_DIR" \
-            -DQT_BUILD_EXAMPLES=OFF \
-            -DQT_BUILD_TESTS=OFF \
-            -DQT_FORCE_BUILD_TOOLS=ON
-    fi
+    cmake "$QT_SRC_DIR" \
+        "${CMAKE_GENERATOR_ARGS[@]}" \
+        -DCMAKE_BUILD_TYPE=Release \
+        -DCMAKE_INSTALL_PREFIX="$INSTALL_HOST_DIR" \
+        -DQT_BUILD_EXAMPLES=OFF \
+        -DQT_BUILD_TESTS=OFF \
+        -DQT_FORCE_BUILD_TOOLS=ON
+}
+
+# Runs in the existing build directory, so a resumed build picks up where it stopped
+compile_qt6_host() {
+    cd "$BUILD_HOST_DIR"
     
     echo_info "Building Qt6 host (this will take 1-2 hours)..."
-    echo_verbose "  Command: cmake --build . --parallel $PARALLEL_JOBS"
-    cmake --build . --parallel "$PARALLEL_JOBS" 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+    echo_verbose "  Command: cmake --build . ${BUILD_JOBS_ARGS[*]}"
+    run_verbose cmake --build . "${BUILD_JOBS_ARGS[@]}"
+}
+
+install_qt6_host() {
+    cd "$BUILD_HOST_DIR"
     
     echo_info "Installing Qt6 host..."
-    cmake --install . 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+    run_verbose cmake --install .
     
     # Verify installation
     if [ -f "$INSTALL_HOST_DIR/libexec/moc" ]; then
@@ -269,11 +424,19 @@ build_qt6_host() {
 build_qt6_windows_base() {
     echo_info "Building Qt6 base (qtbase) for Windows ARM64..."
     
-    if is_installed "qt6-windows-base"; then
+    if [ -z "$RESUME_FROM" ] && is_installed "qt6-windows-base"; then
+        skipped qt6-windows-base
+        checkpoint_done windows_configure windows_build windows_install
         echo_success "Qt6 Windows base already built at $INSTALL_WIN_DIR"
         return
     fi
     
+    run_phase windows_configure 55 "Configuring Qt6 Windows" configure_qt6_windows_base
+    run_phase windows_build 70 "Building Qt6 Windows base" compile_qt6_windows_base
+    run_phase windows_install 85 "Installing Qt6 Windows base" install_qt6_windows_base
+}
+
+configure_qt6_windows_base() {
     mkdir -p "$BUILD_WIN_DIR"
     cd "$BUILD_WIN_DIR"
     
@@ -283,25 +446,28 @@ build_qt6_windows_base() {
     echo_verbose "  Host path: $INSTALL_HOST_DIR"
     echo_verbose "  Install prefix: $INSTALL_WIN_DIR"
     
-    cmake "$QT_SRC_DIR/qtbase" \
+    run_verbose cmake "$QT_SRC_DIR/qtbase" \
+        "${CMAKE_GENERATOR_ARGS[@]}" \
         -DCMAKE_TOOLCHAIN_FILE="$HOME_DIR/llvm-mingw-toolchain.cmake" \
         -DQT_HOST_PATH="$INSTALL_HOST_DIR" \
         -DCMAKE_INSTALL_PREFIX="$INSTALL_WIN_DIR" \
         -DCMAKE_BUILD_TYPE=Release \
         -DQT_BUILD_EXAMPLES=OFF \
-        -DQT_BUILD_TESTS=OFF 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+        -DQT_BUILD_TESTS=OFF
+}
+
+compile_qt6_windows_base() {
+    cd "$BUILD_WIN_DIR"
     
     echo_info "Building Qt6 Windows base (this will take 30-60 minutes)..."
-    cmake --build . --parallel "$PARALLEL_JOBS" 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+    run_verbose cmake --build . "${BUILD_JOBS_ARGS[@]}"
+}
+
+install_qt6_windows_base() {
+    cd "$BUILD_WIN_DIR"
     
     echo_info "Installing Qt6 Windows base..."
-    cmake --install . 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+    run_verbose cmake --install .
     
     # Verify installation
     if [ -f "$INSTALL_WIN_DIR/lib/cmake/Qt6/Qt6Config.cmake" ]; then
@@ -325,22 +491,17 @@ build_qt6_windows_qml() {
         cd "$HOME_DIR/qt6-build-host-macos-shadertools"
         
         echo_verbose "  Configuring qtshadertools (host)..."
-        cmake "$QT_SRC_DIR/qtshadertools" \
+        run_verbose cmake "$QT_SRC_DIR/qtshadertools" \
+            "${CMAKE_GENERATOR_ARGS[@]}" \
             -DCMAKE_PREFIX_PATH="$INSTALL_HOST_DIR" \
             -DCMAKE_INSTALL_PREFIX="$INSTALL_HOST_DIR" \
             -DCMAKE_BUILD_TYPE=Release \
             -DQT_BUILD_EXAMPLES=OFF \
-            -DQT_BUILD_TESTS=OFF 2>&1 | while IFS= read -r line; do
-            echo_verbose "$line"
-        done
+            -DQT_BUILD_TESTS=OFF
         
         echo_verbose "  Building qtshadertools (host)..."
-        cmake --build . --parallel "$PARALLEL_JOBS" 2>&1 | while IFS= read -r line; do
-            echo_verbose "$line"
-        done
-        cmake --install . 2>&1 | while IFS= read -r line; do
-            echo_verbose "$line"
-        done
+        run_verbose cmake --build . "${BUILD_JOBS_ARGS[@]}"
+        run_verbose cmake --install .
         
         # Build qtdeclarative for host
         echo_info "Building qtdeclarative for host..."
@@ -348,31 +509,28 @@ build_qt6_windows_qml() {
         cd "$HOME_DIR/qt6-build-host-macos-declarative"
         
         echo_verbose "  Configuring qtdeclarative (host)..."
-        cmake "$QT_SRC_DIR/qtdeclarative" \
+        run_verbose cmake "$QT_SRC_DIR/qtdeclarative" \
+            "${CMAKE_GENERATOR_ARGS[@]}" \
             -DCMAKE_PREFIX_PATH="$INSTALL_HOST_DIR" \
             -DCMAKE_INSTALL_PREFIX="$INSTALL_HOST_DIR" \
             -DCMAKE_BUILD_TYPE=Release \
             -DQT_BUILD_EXAMPLES=OFF \
             -DQT_BUILD_TESTS=OFF \
-            -DQT_FORCE_BUILD_TOOLS=ON 2>&1 | while IFS= read -r line; do
-            echo_verbose "$line"
-        done
+            -DQT_FORCE_BUILD_TOOLS=ON
         
         echo_verbose "  Building qtdeclarative (host)..."
-        cmake --build . --parallel "$PARALLEL_JOBS" 2>&1 | while IFS= read -r line; do
-            echo_verbose "$line"
-        done
-        cmake --install . 2>&1 | while IFS= read -r line; do
-            echo_verbose "$line"
-        done
+        run_verbose cmake --build . "${BUILD_JOBS_ARGS[@]}"
+        run_verbose cmake --install .
         
         echo_success "Qt6 host QML tools installed"
     else
+        skipped qt6-host-qml
         echo_success "Qt6 host QML tools already installed"
     fi
     
     # Check if Windows QML is installed
     if is_installed "qt6-windows-qml"; then
+        skipped qt6-windows-qml
         echo_success "Qt6 Windows QML already built"
         return
     fi
@@ -383,24 +541,19 @@ build_qt6_windows_qml() {
     cd "$HOME_DIR/qt6-build-winarm64-shadertools"
     
     echo_verbose "  Configuring qtshadertools (Windows)..."
-    cmake "$QT_SRC_DIR/qtshadertools" \
+    run_verbose cmake "$QT_SRC_DIR/qtshadertools" \
+        "${CMAKE_GENERATOR_ARGS[@]}" \
         -DCMAKE_TOOLCHAIN_FILE="$HOME_DIR/llvm-mingw-toolchain.cmake" \
         -DQT_HOST_PATH="$INSTALL_HOST_DIR" \
         -DCMAKE_PREFIX_PATH="$INSTALL_WIN_DIR" \
         -DCMAKE_INSTALL_PREFIX="$INSTALL_WIN_DIR" \
         -DCMAKE_BUILD_TYPE=Release \
         -DQT_BUILD_EXAMPLES=OFF \
-        -DQT_BUILD_TESTS=OFF 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+        -DQT_BUILD_TESTS=OFF
     
     echo_verbose "  Building qtshadertools (Windows)..."
-    cmake --build . --parallel "$PARALLEL_JOBS" 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
-    cmake --install . 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+    run_verbose cmake --build . "${BUILD_JOBS_ARGS[@]}"
+    run_verbose cmake --install .
     
     # Build qtdeclarative for Windows
     echo_info "Building qtdeclarative for Windows..."
@@ -408,24 +561,19 @@ build_qt6_windows_qml() {
     cd "$HOME_DIR/qt6-build-winarm64-declarative"
     
     echo_verbose "  Configuring qtdeclarative (Windows)..."
-    cmake "$QT_SRC_DIR/qtdeclarative" \
+    run_verbose cmake "$QT_SRC_DIR/qtdeclarative" \
+        "${CMAKE_GENERATOR_ARGS[@]}" \
         -DCMAKE_TOOLCHAIN_FILE="$HOME_DIR/llvm-mingw-toolchain.cmake" \
         -DQT_HOST_PATH="$INSTALL_HOST_DIR" \
         -DCMAKE_PREFIX_PATH="$INSTALL_WIN_DIR" \
         -DCMAKE_INSTALL_PREFIX="$INSTALL_WIN_DIR" \
         -DCMAKE_BUILD_TYPE=Release \
         -DQT_BUILD_EXAMPLES=OFF \
-        -DQT_BUILD_TESTS=OFF 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+        -DQT_BUILD_TESTS=OFF
     
     echo_verbose "  Building qtdeclarative (Windows)..."
-    cmake --build . --parallel "$PARALLEL_JOBS" 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
-    cmake --install . 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+    run_verbose cmake --build . "${BUILD_JOBS_ARGS[@]}"
+    run_verbose cmake --install .
     
     echo_success "Qt6 QML modules built successfully!"
 }
@@ -435,6 +583,7 @@ create_test_app() {
     echo_info "Creating test application..."
     
     if is_installed "test-app"; then
+        skipped test-app
         echo_success "Test application already exists at $HOME_DIR/qt6-hello-test"
         return
     fi
@@ -524,16 +673,13 @@ build_test_app() {
     cd "$TEST_DIR/build-macos"
     
     echo_verbose "  Configuring for macOS..."
-    cmake .. \
+    run_verbose cmake .. \
+        "${CMAKE_GENERATOR_ARGS[@]}" \
         -DCMAKE_PREFIX_PATH="$INSTALL_HOST_DIR" \
-        -DCMAKE_BUILD_TYPE=Release 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+        -DCMAKE_BUILD_TYPE=Release
     
     echo_verbose "  Building for macOS..."
-    cmake --build . 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+    run_verbose cmake --build .
     
     echo_success "macOS application built: $TEST_DIR/build-macos/qt6hello"
     echo_info "Run with: $TEST_DIR/build-macos/qt6hello"
@@ -544,23 +690,26 @@ build_test_app() {
     cd "$TEST_DIR/build-windows"
     
     echo_verbose "  Configuring for Windows..."
-    cmake .. \
+    run_verbose cmake .. \
+        "${CMAKE_GENERATOR_ARGS[@]}" \
         -DCMAKE_TOOLCHAIN_FILE="$HOME_DIR/llvm-mingw-toolchain.cmake" \
         -DQT_HOST_PATH="$INSTALL_HOST_DIR" \
         -DCMAKE_PREFIX_PATH="$INSTALL_WIN_DIR" \
-        -DCMAKE_BUILD_TYPE=Release 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+        -DCMAKE_BUILD_TYPE=Release
     
     echo_verbose "  Building for Windows..."
-    cmake --build . 2>&1 | while IFS= read -r line; do
-        echo_verbose "$line"
-    done
+    run_verbose cmake --build .
     
     echo_success "Windows application built: $TEST_DIR/build-windows/qt6hello.exe"
     file "$TEST_DIR/build-windows/qt6hello.exe"
 }
 
+# Test application sources and both of its builds
+build_test_application() {
+    create_test_app
+    build_test_app
+}
+
 # Main installation flow
 main() {
     echo_info "====================================="
@@ -572,26 +721,33 @@ main() {
     echo_info "Checking installation status..."
     echo ""
     
+    # Always run: it also picks the build tool and job settings
+    phase_start prerequisites 5 "Checking prerequisites"
     check_prerequisites
-    setup_llvm_mingw
-    create_toolchain_file
-    download_qt6_source
+    phase_end prerequisites
+    init_checkpoint
+    
+    run_phase llvm_mingw 10 "Setting up llvm-mingw" setup_toolchain
+    run_phase qt_source 15 "Downloading Qt6 source" download_qt6_source
+    
     build_qt6_host
     build_qt6_windows_base
     
     if [[ $BUILD_QML =~ ^[Yy]$ ]]; then
-        build_qt6_windows_qml
+        run_phase qml 88 "Building Qt6 QML modules" build_qt6_windows_qml
     else
+        skipped qml
+        checkpoint_done qml
         echo_info "Skipping QML build (BUILD_QML not set to 'y')"
     fi
     
-    create_test_app
-    build_test_app
+    run_phase test_app 95 "Building test application" build_test_application
     
     echo ""
     echo_success "====================================="
     echo_success "Installation Complete!"
     echo_success "====================================="
+    emit_event done ',"progress":100'
     echo_info "Qt6 Host (macOS): $INSTALL_HOST_DIR"
     echo_info "Qt6 Windows: $INSTALL_WIN_DIR"
     echo_info "Test app: $HOME_DIR/qt6-hello-test"
@@ -603,4 +759,5 @@ main() {
 }
 
 # Run main
+trap on_exit EXIT
 main
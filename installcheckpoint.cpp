@@ -0,0 +1,40 @@
+#include "installcheckpoint.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+
+QString InstallCheckpoint::defaultPath()
+{
+    const QString overridePath = qEnvironmentVariable("INSTALLER_CHECKPOINT");
+    if (!overridePath.isEmpty()) return overridePath;
+
+    return QDir::homePath() + "/.qt6-installer-checkpoint";
+}
+
+bool InstallCheckpoint::load(const QString &path, QString *errorString)
+{
+    failed.clear();
+    failedName.clear();
+
+    QFile file(path);
+    if (!file.exists()) return true;
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+
+    while (!file.atEnd()) {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        const QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+        if (fields.size() < 3) continue;
+
+        if (fields[0] == "failed") {
+            // The script appends one failure at most per run; the last one wins
+            failed = fields[1];
+            failedName = fields.mid(3).join(' ');
+            if (failedName.isEmpty()) failedName = failed;
+        }
+    }
+    return true;
+}
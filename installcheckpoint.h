@@ -0,0 +1,31 @@
+#ifndef INSTALLCHECKPOINT_H
+#define INSTALLCHECKPOINT_H
+
+#include <QString>
+
+// The phase checkpoint install.sh keeps between runs.
+//
+// A plain text file: "done <phase> <config>" for every finished phase and,
+// after a failure, "failed <phase> <config> <title>". <config> is a hash of
+// the settings that shaped the phase's output. Running the script with
+// RESUME_FROM=<phase> skips the phases before it, provided they are all
+// recorded as done with the current settings; otherwise it runs them all.
+class InstallCheckpoint
+{
+public:
+    // $INSTALLER_CHECKPOINT, or ~/.qt6-installer-checkpoint like the script
+    static QString defaultPath();
+
+    // A missing file is an empty checkpoint, not an error
+    bool load(const QString &path, QString *errorString = nullptr);
+
+    // Phase the last run failed in, or empty if it did not fail
+    QString failedPhase() const { return failed; }
+    QString failedTitle() const { return failedName; }
+
+private:
+    QString failed;
+    QString failedName;
+};
+
+#endif // INSTALLCHECKPOINT_H
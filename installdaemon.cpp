@@ -0,0 +1,440 @@
+#include "installdaemon.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <cstdio>
+
+#if defined(Q_OS_UNIX)
+#include <csignal>
+#include <unistd.h>
+#endif
+
+#include "logwriter.h"
+
+using DaemonProtocol::Message;
+
+namespace
+{
+
+constexpr int ProbeTimeoutMs = 1000;
+
+} // namespace
+
+InstallDaemon::InstallDaemon(QObject *parent)
+    : QObject(parent)
+    , server(new QLocalServer(this))
+    , lineQueue(LineQueueCapacity)
+    , idleTimer(new QTimer(this))
+{
+    connect(server, &QLocalServer::newConnection, this, &InstallDaemon::acceptClients);
+
+    // Same threads as the GUI had: the worker reads and classifies, the writer saves
+    workerThread = new QThread(this);
+    worker = new InstallWorker(&lineQueue, &sessionClock);
+    worker->moveToThread(workerThread);
+    connect(worker, &InstallWorker::linesReady, this, &InstallDaemon::drainLines);
+    connect(worker, &InstallWorker::progressChanged, this, &InstallDaemon::updateProgress);
+    connect(worker, &InstallWorker::processStarted, this, &InstallDaemon::processStarted);
+    connect(worker, &InstallWorker::pausedChanged, this, &InstallDaemon::processPausedChanged);
+    connect(worker, &InstallWorker::failedToStart, this, &InstallDaemon::processFailedToStart);
+    connect(worker, &InstallWorker::finished, this, &InstallDaemon::processFinished);
+    workerThread->start();
+
+    writerThread = new QThread(this);
+    logWriter = new LogWriter();
+    logWriter->moveToThread(writerThread);
+    connect(logWriter, &LogWriter::failed, this, [this](const QString &errorString) {
+        appendMessage(QString("Session log disabled: %1\n").arg(errorString), LineClass::Warning);
+    });
+    writerThread->start();
+
+    idleTimer->setSingleShot(true);
+    idleTimer->setInterval(IdleTimeoutMs);
+    connect(idleTimer, &QTimer::timeout, qApp, &QCoreApplication::quit);
+    updateIdleTimer();
+}
+
+InstallDaemon::~InstallDaemon()
+{
+    QMetaObject::invokeMethod(worker, &InstallWorker::shutdown, Qt::BlockingQueuedConnection);
+    workerThread->quit();
+    workerThread->wait();
+    delete worker;
+
+    QMetaObject::invokeMethod(logWriter, &LogWriter::close, Qt::BlockingQueuedConnection);
+    writerThread->quit();
+    writerThread->wait();
+    delete logWriter;
+}
+
+int InstallDaemon::run(int argc, char *argv[])
+{
+#if defined(Q_OS_UNIX)
+    // Leave the session of whoever started us, so closing their terminal is no hangup
+    ::setsid();
+    std::signal(SIGHUP, SIG_IGN);
+#endif
+
+    QCoreApplication app(argc, argv);
+
+    InstallDaemon daemon;
+    QString errorString;
+    if (!daemon.listen(&errorString)) {
+        std::fprintf(stderr, "Installer daemon not started: %s\n", qPrintable(errorString));
+        return 1;
+    }
+    return app.exec();
+}
+
+bool InstallDaemon::listen(QString *errorString)
+{
+    const QString name = DaemonProtocol::serverName();
+    if (name.isEmpty()) {
+        *errorString = "no private runtime directory for the socket (check XDG_RUNTIME_DIR)";
+        return false;
+    }
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    if (server->listen(name)) return true;
+
+    // A daemon that crashed leaves its socket behind; only remove it if nobody answers
+    if (server->serverError() == QAbstractSocket::AddressInUseError) {
+        QLocalSocket probe;
+        probe.connectToServer(name);
+        if (probe.waitForConnected(ProbeTimeoutMs)) {
+            *errorString = QString("another daemon is listening on %1").arg(name);
+            return false;
+        }
+        QLocalServer::removeServer(name);
+        if (server->listen(name)) return true;
+    }
+    *errorString = server->errorString();
+    return false;
+}
+
+void InstallDaemon::acceptClients()
+{
+    while (QLocalSocket *socket = server->nextPendingConnection()) {
+        // Another user's process gets neither the log nor a say over the build
+        if (!DaemonProtocol::peerIsCurrentUser(socket->socketDescriptor())) {
+            socket->abort();
+            socket->deleteLater();
+            continue;
+        }
+
+        if (client) {
+            detachClient("Another window attached to the installation");
+        }
+
+        // Nothing is sent until the client says Hello
+        client = socket;
+        reader.clear();
+        nextLine = -1;
+        connect(socket, &QLocalSocket::readyRead, this, &InstallDaemon::readClient);
+        connect(socket, &QLocalSocket::bytesWritten, this, [this]() { sendLines(); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            client = nullptr;
+            socket->deleteLater();
+            updateIdleTimer();
+        });
+    }
+    updateIdleTimer();
+}
+
+void InstallDaemon::readClient()
+{
+    reader.feed(client->readAll());
+
+    DaemonProtocol::Message type;
+    QByteArray payload;
+    while (client && reader.next(&type, &payload)) {
+        handleMessage(type, payload);
+    }
+    if (client && reader.isBroken()) {
+        detachClient("Malformed message");
+    }
+}
+
+void InstallDaemon::handleMessage(Message type, const QByteArray &payload)
+{
+    QDataStream in(payload);
+    in.setVersion(DaemonProtocol::StreamVersion);
+
+    switch (type) {
+    case Message::Hello: {
+        quint32 version = 0;
+        bool replay = false;
+        in >> version >> replay;
+        if (version != DaemonProtocol::Version) {
+            detachClient(QString("Protocol version %1 is not supported").arg(version));
+            return;
+        }
+        session.elapsedUs = sessionClock.elapsedUs();
+        client->write(DaemonProtocol::frame(Message::Session, session));
+        nextLine = replay ? 0 : history.lineCount();
+        sendLines();
+        break;
+    }
+    case Message::Start: {
+        QString program;
+        QStringList arguments;
+        QStringList environment;
+        in >> program >> arguments >> environment;
+        if (session.running) {
+            send(DaemonProtocol::frame(Message::FailedToStart, QString("an installation is already running")));
+        } else {
+            startSession(program, arguments, environment);
+        }
+        break;
+    }
+    case Message::Stop:
+        if (session.running && !stopRequested) {
+            // The worker reports back through processFinished()
+            stopRequested = true;
+            appendMessage("\n=== Stopping installation... ===\n", LineClass::Error);
+            QMetaObject::invokeMethod(worker, &InstallWorker::stop);
+        }
+        break;
+    case Message::Pause: {
+        bool pause = false;
+        in >> pause;
+        QMetaObject::invokeMethod(worker, [this, pause]() { worker->setPaused(pause); });
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void InstallDaemon::startSession(const QString &program, const QStringList &arguments, const QStringList &environment)
+{
+    // The previous run's lines are in its session log
+    history.clear();
+    marks.clear();
+    if (nextLine > 0) nextLine = 0;
+    sessionClock.restart();
+    stopRequested = false;
+
+    QProcessEnvironment env;
+    for (const QString &entry : environment) {
+        const qsizetype separator = entry.indexOf('=');
+        if (separator > 0) env.insert(entry.left(separator), entry.mid(separator + 1));
+    }
+
+    session = DaemonSession();
+    session.running = true;
+    session.qml = env.value("BUILD_QML") == "y";
+    session.jobs = env.contains("PARALLEL_JOBS") ? qMax(1, env.value("PARALLEL_JOBS").toInt()) : DefaultParallelJobs;
+    resumeFrom = env.value("RESUME_FROM");
+    updateIdleTimer();
+
+    const QString logPath = LogWriter::sessionPath(LogWriter::defaultDirectory());
+    QMetaObject::invokeMethod(logWriter, [writer = logWriter, logPath]() { writer->open(logPath); });
+
+    // Phase timings of earlier runs drive the ETA; this run is added at the end
+    QString historyError;
+    if (!phaseHistory.load(PhaseHistory::defaultPath(), &historyError)) {
+        appendMessage(QString("Ignoring phase history: %1\n").arg(historyError), LineClass::Warning);
+    }
+    eta.start({QThread::idealThreadCount(), session.jobs, session.qml});
+
+    appendMessage("=== Starting Qt6 Installation ===\n", LineClass::Info);
+    appendMessage(QString("Script: %1\n").arg(arguments.value(0)), LineClass::Detail);
+    appendMessage(QString("QML Support: %1\n").arg(session.qml ? "Yes" : "No"), LineClass::Detail);
+    if (!resumeFrom.isEmpty()) {
+        appendMessage(QString("Resuming from: %1\n").arg(resumeFrom), LineClass::Detail);
+    }
+    appendMessage(QString("Session log: %1\n\n").arg(QDir::toNativeSeparators(logPath)), LineClass::Detail);
+
+    QMetaObject::invokeMethod(worker, [this, program, arguments, env]() {
+        worker->start(program, arguments, env);
+    });
+}
+
+void InstallDaemon::drainLines()
+{
+    worker->acknowledgeLines();
+
+    LogLineBatch batch;
+    while (lineQueue.tryPop(batch)) {
+        addLines(batch);
+    }
+}
+
+void InstallDaemon::appendMessage(const QString &text, LineClass lineClass)
+{
+    // Script lines stamped before this message go ahead of it
+    drainLines();
+
+    QStringList lines = text.split('\n');
+    if (text.endsWith('\n')) lines.removeLast();
+
+    const qint64 timestampUs = sessionClock.elapsedUs();
+    LogLineBatch batch;
+    for (const QString &line : lines) {
+        LogLine logLine{line.toUtf8(), lineClass};
+        logLine.channel = LogChannel::Installer;
+        sessionClock.stamp(&logLine, timestampUs);
+        batch.append(std::move(logLine));
+    }
+    addLines(batch);
+}
+
+void InstallDaemon::addLines(const LogLineBatch &lines)
+{
+    if (lines.isEmpty()) return;
+
+    for (const LogLine &line : lines) {
+        if (line.progress >= 0 || line.diagnostic >= 0) {
+            marks.append({history.lineCount(), line.progress, line.diagnostic});
+        }
+        history.append(line);
+    }
+    QMetaObject::invokeMethod(logWriter, [writer = logWriter, lines]() { writer->append(lines); });
+    eta.addLines(lines);
+    sendLines();
+}
+
+void InstallDaemon::sendLines(bool all)
+{
+    if (!client || nextLine < 0) return;
+
+    auto mark = std::lower_bound(marks.cbegin(), marks.cend(), nextLine,
+                                 [](const LineMark &m, qsizetype line) { return m.line < line; });
+
+    // Lines are sent in big frames, and no more is queued than the socket takes
+    while (nextLine < history.lineCount() && (all || client->bytesToWrite() < ReplayHighWater)) {
+        const qsizetype end = qMin(history.lineCount(), nextLine + ReplayFrameLines);
+        LogLineBatch lines;
+        lines.reserve(end - nextLine);
+        for (; nextLine < end; ++nextLine) {
+            LogLine line{history.line(nextLine).toByteArray(), history.lineClass(nextLine)};
+            if (history.hasSpans(nextLine)) line.spans = history.spans(nextLine);
+            line.channel = history.channel(nextLine);
+            line.sequence = history.sequence(nextLine);
+            line.timestampUs = history.timestampUs(nextLine);
+            if (mark != marks.cend() && mark->line == nextLine) {
+                line.progress = mark->progress;
+                line.diagnostic = mark->diagnostic;
+                ++mark;
+            }
+            lines.append(std::move(line));
+        }
+        client->write(DaemonProtocol::frame(Message::Lines, lines));
+    }
+}
+
+void InstallDaemon::send(const QByteArray &frame, bool afterLines)
+{
+    if (!client || nextLine < 0) return;
+
+    if (afterLines) {
+        sendLines(true);
+    }
+    client->write(frame);
+}
+
+void InstallDaemon::updateProgress(double percent, int stepsDone, int stepsTotal)
+{
+    eta.setSteps(stepsDone, stepsTotal);
+    session.percent = qMax(session.percent, percent);
+    session.stepsDone = stepsDone;
+    session.stepsTotal = stepsTotal;
+    send(DaemonProtocol::frame(Message::Progress, percent, qint32(stepsDone), qint32(stepsTotal)));
+}
+
+void InstallDaemon::processStarted(qint64 pid)
+{
+    session.pid = pid;
+    send(DaemonProtocol::frame(Message::Started, pid));
+}
+
+void InstallDaemon::processPausedChanged(bool paused)
+{
+    session.paused = paused;
+    const qint64 nowUs = sessionClock.elapsedUs();
+    if (paused) {
+        eta.pause(nowUs);
+        appendMessage("=== Paused: build processes stopped ===\n", LineClass::Warning);
+    } else {
+        eta.resume(nowUs);
+        appendMessage("=== Resumed ===\n", LineClass::Info);
+    }
+    send(DaemonProtocol::frame(Message::Paused, paused));
+}
+
+void InstallDaemon::processFailedToStart(const QString &errorString)
+{
+    appendMessage(QString("ERROR: Failed to start installation process! (%1)\n").arg(errorString), LineClass::Error);
+    eta.finish(false, sessionClock.elapsedUs(), &phaseHistory);
+    QMetaObject::invokeMethod(logWriter, &LogWriter::close);
+
+    session.running = false;
+    send(DaemonProtocol::frame(Message::FailedToStart, errorString), true);
+    updateIdleTimer();
+}
+
+void InstallDaemon::processFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    // The worker only emits finished() once its last batch is in the queue
+    const qint64 finishedUs = sessionClock.elapsedUs();
+    drainLines();
+
+    const bool completed = !stopRequested && exitStatus == QProcess::NormalExit && exitCode == 0;
+    eta.resume(finishedUs);
+    if (eta.totalPausedUs() > 0) {
+        appendMessage(QString("Paused for %1 in total\n").arg(EtaEstimator::formatDuration(eta.totalPausedUs() / 1e6)),
+                      LineClass::Detail);
+    }
+    eta.finish(completed, finishedUs, &phaseHistory);
+
+    // A resumed phase only shows its remainder, which would skew the history
+    QString historyError;
+    if (resumeFrom.isEmpty() && !phaseHistory.save(PhaseHistory::defaultPath(), &historyError)) {
+        appendMessage(QString("Phase history not saved: %1\n").arg(historyError), LineClass::Warning);
+    }
+
+    if (stopRequested) {
+        appendMessage("Installation stopped by user.\n", LineClass::Error);
+    } else if (exitStatus == QProcess::CrashExit) {
+        appendMessage("\n=== Process crashed ===\n", LineClass::Error);
+    } else if (exitCode == 0) {
+        appendMessage("\n=== Installation completed successfully! ===\n", LineClass::Success);
+    } else {
+        appendMessage(QString("\n=== Installation failed with exit code %1 ===\n").arg(exitCode), LineClass::Error);
+    }
+    QMetaObject::invokeMethod(logWriter, &LogWriter::close);
+
+    session.running = false;
+    session.paused = false;
+    if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+        session.percent = 100;
+    }
+    send(DaemonProtocol::frame(Message::Finished, qint32(exitCode), quint8(exitStatus)), true);
+    updateIdleTimer();
+}
+
+void InstallDaemon::detachClient(const QString &reason)
+{
+    // The old connection only says goodbye; it is deleted once closed
+    QLocalSocket *socket = client;
+    client = nullptr;
+    socket->disconnect(this);
+    connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+    socket->write(DaemonProtocol::frame(Message::Detached, reason));
+    socket->disconnectFromServer();
+}
+
+void InstallDaemon::updateIdleTimer()
+{
+    if (client || session.running) {
+        idleTimer->stop();
+    } else if (!idleTimer->isActive()) {
+        idleTimer->start();
+    }
+}
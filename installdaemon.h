@@ -0,0 +1,104 @@
+#ifndef INSTALLDAEMON_H
+#define INSTALLDAEMON_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+
+#include "daemonprotocol.h"
+#include "etaestimator.h"
+#include "installworker.h"
+#include "logstore.h"
+#include "phasehistory.h"
+#include "sessionclock.h"
+
+class LogWriter;
+class QLocalServer;
+class QLocalSocket;
+class QThread;
+class QTimer;
+
+// Owns the installation so it outlives the window that started it.
+//
+// Runs as "qt6-installer-gui --daemon" on a QCoreApplication and listens on
+// a QLocalServer at DaemonProtocol::serverName(), dropping any connection
+// from a process of another user. It holds the same engine the GUI used to:
+// InstallWorker, LogWriter and the phase history, and keeps every line of
+// the current run in a LogStore, which spills cold chunks to disk. A client
+// that attaches gets the session state, then the whole run so far in large
+// frames, paced by how fast the socket drains, and then the live stream;
+// replay and live lines come from the same store, so nothing is lost or
+// sent twice. Only one client is attached at a time: a new one detaches the
+// previous window. With no client and no build running, the daemon exits
+// after IdleTimeoutMs.
+class InstallDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit InstallDaemon(QObject *parent = nullptr);
+    ~InstallDaemon();
+
+    // Runs the daemon on a QCoreApplication until it goes idle
+    static int run(int argc, char *argv[]);
+
+    bool listen(QString *errorString);
+
+private slots:
+    void acceptClients();
+    void readClient();
+    void drainLines();
+    void updateProgress(double percent, int stepsDone, int stepsTotal);
+    void processStarted(qint64 pid);
+    void processPausedChanged(bool paused);
+    void processFailedToStart(const QString &errorString);
+    void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    void handleMessage(DaemonProtocol::Message type, const QByteArray &payload);
+    void startSession(const QString &program, const QStringList &arguments, const QStringList &environment);
+    void appendMessage(const QString &text, LineClass lineClass);
+    void addLines(const LogLineBatch &lines);
+    void sendLines(bool all = false);
+    void send(const QByteArray &frame, bool afterLines = false);
+    void detachClient(const QString &reason);
+    void updateIdleTimer();
+
+    static constexpr int IdleTimeoutMs = 10 * 60 * 1000;
+    static constexpr std::size_t LineQueueCapacity = 1024;
+    static constexpr int DefaultParallelJobs = 4;   // install.sh's own default
+    static constexpr qsizetype ReplayFrameLines = 16384;
+    static constexpr qint64 ReplayHighWater = 4 * 1024 * 1024;
+
+    QLocalServer *server;
+    QLocalSocket *client = nullptr;
+    DaemonProtocol::FrameReader reader;
+    // Milestone and diagnostic ids, which the store does not keep
+    struct LineMark
+    {
+        qsizetype line = 0;
+        int progress = -1;
+        int diagnostic = -1;
+    };
+
+    LogStore history;               // every line of the current run
+    QList<LineMark> marks;          // in line order, only for lines that have one
+    qsizetype nextLine = -1;        // first line the client lacks; -1 until its Hello
+
+    LogBatchQueue lineQueue;
+    SessionClock sessionClock;
+    QThread *workerThread;
+    InstallWorker *worker;
+    QThread *writerThread;
+    LogWriter *logWriter;
+    QTimer *idleTimer;
+    PhaseHistory phaseHistory;
+    EtaEstimator eta;
+    DaemonSession session;
+    QString resumeFrom;             // RESUME_FROM of the current run
+    bool stopRequested = false;
+};
+
+#endif // INSTALLDAEMON_H
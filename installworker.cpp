@@ -0,0 +1,430 @@
+#include "installworker.h"
+
+#include "jobserver.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSocketNotifier>
+#include <QThread>
+#include <QTimer>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+InstallWorker::InstallWorker(LogBatchQueue *queue, SessionClock *clock, QObject *parent)
+    : QObject(parent)
+    , process(new QProcess(this))
+    , retryTimer(new QTimer(this))
+    , killTimer(new QTimer(this))
+    , jobServer(new JobServer(this))
+    , queue(queue)
+    , clock(clock)
+{
+    connect(process, &QProcess::readyReadStandardOutput, this, &InstallWorker::handleStdout);
+    connect(process, &QProcess::readyReadStandardError, this, &InstallWorker::handleStderr);
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &InstallWorker::handleFinished);
+    connect(process, &QProcess::errorOccurred, this, &InstallWorker::handleError);
+
+    // The queue was full: keep accumulating and try again next frame
+    retryTimer->setInterval(RetryIntervalMs);
+    connect(retryTimer, &QTimer::timeout, this, &InstallWorker::publish);
+
+    // Whatever survives SIGTERM this long gets SIGKILL
+    killTimer->setSingleShot(true);
+    killTimer->setInterval(StopTimeoutMs);
+    connect(killTimer, &QTimer::timeout, this, &InstallWorker::killProcessGroup);
+
+    connect(jobServer, &JobServer::limitChanged, this, [this](int jobs, const QString &reason) {
+        appendInstallerLine(QString("Build jobs: %1 (%2)").arg(jobs).arg(reason), LineClass::Detail, -1);
+        publish();
+    });
+
+    connect(process, &QProcess::started, this, [this]() {
+#if defined(Q_OS_UNIX)
+        // Also set from the parent, in case a stop comes before the child ran its modifier
+        processGroup = process->processId();
+        ::setpgid(pid_t(processGroup), pid_t(processGroup));
+#endif
+        emit processStarted(process->processId());
+    });
+}
+
+void InstallWorker::start(const QString &program, const QStringList &arguments, const QProcessEnvironment &environment)
+{
+    reportedProgress = 0;
+    finishPending = false;
+    eventsActive = false;
+    eventFramer.reset();
+    stdoutFramer.reset();
+    stderrFramer.reset();
+    stdoutAnsi.reset();
+    stderrAnsi.reset();
+    diagnostics.clear();
+
+    // Custom rules are picked up at the start of every run
+    classifier = LineClassifier();
+    const QString rulesPath = LineClassifier::defaultRulesPath();
+    QString errorString;
+    if (!classifier.loadRules(rulesPath, &errorString)) {
+        LogLine line{QString("Ignoring rules file %1: %2").arg(rulesPath, errorString).toUtf8(), LineClass::Warning};
+        line.channel = LogChannel::Installer;
+        clock->stamp(&line, clock->elapsedUs());
+        backlog.append(line);
+        publish();
+    }
+    progress.setMilestones(classifier.milestones());
+
+    QProcessEnvironment childEnvironment = environment;
+    if (openEventChannel()) {
+        childEnvironment.insert("INSTALLER_EVENT_FD", QString::number(EventFd));
+    }
+
+    // Every core is a possible slot; memory decides how many are handed out
+    if (JobServer::isSupported()) {
+        if (jobServer->open(QThread::idealThreadCount(), &errorString)) {
+            childEnvironment.insert("MAKEFLAGS", jobServer->makeflags());
+            childEnvironment.insert("INSTALLER_JOBSERVER", "1");
+        } else {
+            appendInstallerLine(QString("Jobserver disabled: %1").arg(errorString), LineClass::Warning, -1);
+            publish();
+        }
+    }
+    process->setProcessEnvironment(childEnvironment);
+
+#if defined(Q_OS_UNIX)
+    // Runs between fork and exec. The script leads its own process group, so
+    // a stop reaches cmake, ninja and every compiler it started.
+    if (killTimer->isActive()) {
+        killTimer->stop();
+        killProcessGroup();
+    }
+    processGroup = 0;
+    paused = false;
+    const int writeFd = eventWriteFd;
+    process->setChildProcessModifier([writeFd]() {
+        ::setpgid(0, 0);
+        if (writeFd < 0) return;
+
+        // dup2 leaves the new descriptor inheritable; an fd already at 3 is not
+        if (writeFd == EventFd) {
+            ::fcntl(EventFd, F_SETFD, 0);
+        } else {
+            ::dup2(writeFd, EventFd);
+        }
+    });
+#endif
+    process->start(program, arguments);
+
+#if defined(Q_OS_UNIX)
+    // The child has its copy; ours would keep the pipe from ever reaching EOF
+    if (eventWriteFd >= 0) {
+        ::close(eventWriteFd);
+        eventWriteFd = -1;
+    }
+#endif
+}
+
+bool InstallWorker::canPause()
+{
+#if defined(Q_OS_UNIX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void InstallWorker::stop()
+{
+    if (process->state() == QProcess::NotRunning) return;
+
+#if defined(Q_OS_UNIX)
+    // Never blocks: the group is checked again when the timer fires
+    if (processGroup > 0) {
+        ::kill(-pid_t(processGroup), SIGTERM);
+        killTimer->start();
+
+        // A stopped process only sees SIGTERM once it runs again
+        setPaused(false);
+        return;
+    }
+#endif
+    process->kill();
+}
+
+void InstallWorker::setPaused(bool pause)
+{
+#if defined(Q_OS_UNIX)
+    if (pause == paused || processGroup <= 0) return;
+    if (pause && process->state() == QProcess::NotRunning) return;
+
+    if (::kill(-pid_t(processGroup), pause ? SIGSTOP : SIGCONT) != 0) return;
+    paused = pause;
+    emit pausedChanged(paused);
+#else
+    Q_UNUSED(pause);
+#endif
+}
+
+void InstallWorker::killProcessGroup()
+{
+#if defined(Q_OS_UNIX)
+    // Signal 0 only checks whether anything in the group is still alive
+    if (processGroup <= 0 || ::kill(-pid_t(processGroup), 0) != 0) return;
+
+    ::kill(-pid_t(processGroup), SIGKILL);
+    appendInstallerLine(QString("Build processes ignored SIGTERM for %1 s and were killed").arg(StopTimeoutMs / 1000),
+                        LineClass::Warning, -1);
+    publish();
+#else
+    process->kill();
+#endif
+}
+
+void InstallWorker::shutdown()
+{
+    // The application is quitting: a bounded wait here, then nothing survives
+    if (process->state() != QProcess::NotRunning) {
+        stop();
+        if (!process->waitForFinished(StopTimeoutMs)) {
+            process->kill();
+            process->waitForFinished();
+        }
+    }
+    killTimer->stop();
+    jobServer->close();
+
+#if defined(Q_OS_UNIX)
+    if (processGroup > 0) {
+        ::kill(-pid_t(processGroup), SIGKILL);
+    }
+#endif
+}
+
+void InstallWorker::handleStdout()
+{
+    ingest(process->readAllStandardOutput(), false);
+}
+
+void InstallWorker::handleStderr()
+{
+    ingest(process->readAllStandardError(), true);
+}
+
+void InstallWorker::handleFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    // Leftovers in the group must not stay frozen forever
+    setPaused(false);
+
+    // Everything the script printed must reach the consumer before the verdict
+    handleEvents();
+    closeEventChannel();
+    jobServer->close();
+    ingest(process->readAllStandardOutput(), false);
+    ingest(process->readAllStandardError(), true);
+    flushPartialLines();
+    finishPending = true;
+    finishedExitCode = exitCode;
+    finishedStatus = exitStatus;
+    publish();
+}
+
+void InstallWorker::handleError(QProcess::ProcessError error)
+{
+    if (error == QProcess::FailedToStart) {
+        closeEventChannel();
+        jobServer->close();
+        emit failedToStart(process->errorString());
+    }
+}
+
+void InstallWorker::ingest(QByteArrayView data, bool isStderr)
+{
+    if (data.isEmpty()) return;
+
+    // Every line framed from one read arrived at the same time
+    const qint64 timestampUs = clock->elapsedUs();
+    auto sink = [&](QByteArrayView bytes) {
+        appendLine(bytes, isStderr, timestampUs);
+    };
+
+    if (isStderr) {
+        stderrFramer.feed(data, sink);
+    } else {
+        stdoutFramer.feed(data, sink);
+    }
+
+    reportProgress();
+    publish();
+}
+
+void InstallWorker::reportProgress()
+{
+    // One report per read at most, and only when the bar would visibly move
+    const int tenths = int(progress.percent() * 10);
+    if (tenths > reportedProgress) {
+        reportedProgress = tenths;
+        emit progressChanged(progress.percent(), progress.stepsDone(), progress.stepsTotal());
+    }
+}
+
+bool InstallWorker::openEventChannel()
+{
+    closeEventChannel();
+
+#if defined(Q_OS_UNIX)
+    int fds[2];
+    if (::pipe(fds) != 0) return false;
+
+    // Neither end leaks into the child as is; the child modifier places the write end
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    eventReadFd = fds[0];
+    eventWriteFd = fds[1];
+
+    eventNotifier = new QSocketNotifier(eventReadFd, QSocketNotifier::Read, this);
+    connect(eventNotifier, &QSocketNotifier::activated, this, &InstallWorker::handleEvents);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void InstallWorker::closeEventChannel()
+{
+#if defined(Q_OS_UNIX)
+    delete eventNotifier;
+    eventNotifier = nullptr;
+    if (eventReadFd >= 0) ::close(eventReadFd);
+    if (eventWriteFd >= 0) ::close(eventWriteFd);
+    eventReadFd = -1;
+    eventWriteFd = -1;
+#endif
+}
+
+void InstallWorker::handleEvents()
+{
+#if defined(Q_OS_UNIX)
+    if (eventReadFd < 0) return;
+
+    auto sink = [this](QByteArrayView bytes) { handleEvent(bytes); };
+    char buffer[4096];
+    for (;;) {
+        const ssize_t count = ::read(eventReadFd, buffer, sizeof(buffer));
+        if (count > 0) {
+            eventFramer.feed(QByteArrayView(buffer, count), sink);
+        } else if (count == 0) {
+            // The script and everything it started have closed the pipe
+            eventFramer.finish(sink);
+            eventNotifier->setEnabled(false);
+            break;
+        } else {
+            break;  // EAGAIN: drained for now
+        }
+    }
+
+    reportProgress();
+    publish();
+#endif
+}
+
+void InstallWorker::handleEvent(QByteArrayView bytes)
+{
+    // Events are rare and small; a full JSON parse per event costs nothing
+    const QJsonObject event = QJsonDocument::fromJson(bytes.toByteArray()).object();
+    const QString type = event.value("event").toString();
+
+    if (type == QLatin1String("phase_start")) {
+        eventsActive = true;
+        const int milestone = event.value("progress").toInt(-1);
+        appendInstallerLine(event.value("title").toString(), LineClass::Section, milestone);
+        if (milestone >= 0) progress.reachMilestone(milestone);
+    } else if (type == QLatin1String("phase_end")) {
+        progress.completePhase();
+    } else if (type == QLatin1String("skipped")) {
+        appendInstallerLine(QString("Skipped %1 (already installed)").arg(event.value("component").toString()),
+                            LineClass::Detail, -1);
+    } else if (type == QLatin1String("done")) {
+        eventsActive = true;
+        progress.reachMilestone(100);
+    }
+}
+
+void InstallWorker::appendInstallerLine(const QString &text, LineClass lineClass, int milestone)
+{
+    LogLine line{text.toUtf8(), lineClass};
+    line.channel = LogChannel::Installer;
+    line.progress = milestone;
+    clock->stamp(&line, clock->elapsedUs());
+    backlog.append(std::move(line));
+}
+
+void InstallWorker::appendLine(QByteArrayView bytes, bool isStderr, qint64 timestampUs)
+{
+    // Escapes are turned into style spans before any keyword is matched
+    StyleSpans spans;
+    AnsiParser &ansi = isStderr ? stderrAnsi : stdoutAnsi;
+    if (ansi.process(bytes, &strippedLine, &spans)) {
+        bytes = strippedLine;
+    }
+
+    LogLine line{bytes.toByteArray(), LineClass::Stderr, spans, LogChannel::Stderr};
+    clock->stamp(&line, timestampUs);
+
+    // Color, progress and diagnostic keywords are matched in the same pass
+    const LineClassifier::Result result = classifier.classify(bytes);
+    if (result.maybeDiagnostic) {
+        line.diagnostic = diagnostics.intern(bytes);
+    }
+
+    if (!isStderr) {
+        line.lineClass = result.lineClass;
+        line.channel = LogChannel::Stdout;
+        // Build counters move the bar between two milestones
+        if (result.progress >= 0 && !eventsActive) {
+            line.progress = result.progress;
+            progress.reachMilestone(result.progress);
+        } else if (result.progress < 0) {
+            progress.addStatusLine(bytes);
+        }
+    }
+    backlog.append(std::move(line));
+}
+
+void InstallWorker::flushPartialLines()
+{
+    const qint64 timestampUs = clock->elapsedUs();
+    stdoutFramer.finish([this, timestampUs](QByteArrayView bytes) {
+        appendLine(bytes, false, timestampUs);
+    });
+    stderrFramer.finish([this, timestampUs](QByteArrayView bytes) {
+        appendLine(bytes, true, timestampUs);
+    });
+}
+
+void InstallWorker::publish()
+{
+    if (!backlog.isEmpty() && queue->tryPush(std::move(backlog))) {
+        backlog = LogLineBatch();
+    }
+
+    if (backlog.isEmpty()) {
+        retryTimer->stop();
+    } else if (!retryTimer->isActive()) {
+        retryTimer->start();
+    }
+
+    if (!queue->isEmpty() && !wakeupPending.exchange(true, std::memory_order_acq_rel)) {
+        emit linesReady();
+    }
+
+    // A full queue defers the verdict to the retry timer
+    if (backlog.isEmpty() && finishPending) {
+        finishPending = false;
+        emit finished(finishedExitCode, finishedStatus);
+    }
+}
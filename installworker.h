@@ -0,0 +1,127 @@
+#ifndef INSTALLWORKER_H
+#define INSTALLWORKER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+
+#include <atomic>
+
+#include "ansiparser.h"
+#include "diagnosticparser.h"
+#include "lineclassifier.h"
+#include "lineframer.h"
+#include "logline.h"
+#include "progressestimator.h"
+#include "sessionclock.h"
+#include "spscqueue.h"
+
+class JobServer;
+class QSocketNotifier;
+class QTimer;
+
+using LogBatchQueue = SpscQueue<LogLineBatch>;
+
+// Runs install.sh on a worker thread.
+//
+// Owns the QProcess and does all reading, UTF-8 decoding and classification
+// off the GUI thread. Classified lines are handed over in batches through a
+// single-producer/single-consumer queue; linesReady() is only emitted when
+// the consumer has drained everything it was told about, so a burst of
+// output costs the GUI thread one wakeup per frame, not one per read.
+// Lines from both channels are stamped in the order they are read.
+// finished() is held back until the last line is in the queue.
+//
+// On Unix the script also gets a pipe on fd 3 (named by INSTALLER_EVENT_FD)
+// for JSON-lines events: phase_start, phase_end, skipped and done. Phases
+// announced there become installer lines carrying the milestone, and once
+// the first event arrives, milestone keywords in the log text are ignored.
+// Build step counters are still taken from ninja's status lines.
+//
+// The script leads its own process group. stop() sends SIGTERM to the whole
+// group and returns at once; whatever is left after StopTimeoutMs gets
+// SIGKILL, even if bash itself has already exited. setPaused() stops and
+// continues the same group with SIGSTOP and SIGCONT.
+//
+// Where JobServer is supported, the build takes its job slots from it
+// through MAKEFLAGS instead of a fixed PARALLEL_JOBS.
+class InstallWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    InstallWorker(LogBatchQueue *queue, SessionClock *clock, QObject *parent = nullptr);
+
+    // Called by the consumer right before it drains the queue
+    void acknowledgeLines() { wakeupPending.store(false, std::memory_order_release); }
+
+    // Pausing needs process groups, so only Unix has it
+    static bool canPause();
+
+public slots:
+    void start(const QString &program, const QStringList &arguments, const QProcessEnvironment &environment);
+    void stop();
+    void setPaused(bool paused);
+    void shutdown();
+
+signals:
+    void linesReady();
+    void progressChanged(double percent, int stepsDone, int stepsTotal);
+    void processStarted(qint64 pid);
+    void pausedChanged(bool paused);
+    void failedToStart(const QString &errorString);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private slots:
+    void handleStdout();
+    void handleStderr();
+    void handleFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void handleError(QProcess::ProcessError error);
+    void handleEvents();
+    void killProcessGroup();
+
+private:
+    void ingest(QByteArrayView data, bool isStderr);
+    void appendLine(QByteArrayView bytes, bool isStderr, qint64 timestampUs);
+    void flushPartialLines();
+    void publish();
+    void reportProgress();
+    bool openEventChannel();
+    void closeEventChannel();
+    void handleEvent(QByteArrayView bytes);
+    void appendInstallerLine(const QString &text, LineClass lineClass, int milestone);
+
+    static constexpr int RetryIntervalMs = 16;
+    static constexpr int EventFd = 3;
+    static constexpr int StopTimeoutMs = 5000;
+
+    QProcess *process;
+    QTimer *retryTimer;
+    QTimer *killTimer;
+    JobServer *jobServer;
+    LogBatchQueue *queue;
+    SessionClock *clock;
+    LineClassifier classifier;
+    ProgressEstimator progress;
+    DiagnosticParser diagnostics;
+    LineFramer stdoutFramer;
+    LineFramer stderrFramer;
+    AnsiParser stdoutAnsi;
+    AnsiParser stderrAnsi;
+    QByteArray strippedLine;    // reused buffer for lines with escapes
+    LogLineBatch backlog;       // lines not yet accepted by the queue
+    std::atomic<bool> wakeupPending{false};
+    QSocketNotifier *eventNotifier = nullptr;
+    LineFramer eventFramer;
+    int eventReadFd = -1;
+    int eventWriteFd = -1;      // the child's end, open only until it is started
+    bool eventsActive = false;  // the script reports its own phases
+    qint64 processGroup = 0;    // the script's pid, which leads the group
+    bool paused = false;
+    int reportedProgress = 0;   // in tenths of a percent
+    bool finishPending = false; // finished() waits until the backlog is queued
+    int finishedExitCode = 0;
+    QProcess::ExitStatus finishedStatus = QProcess::NormalExit;
+};
+
+#endif // INSTALLWORKER_H
@@ -0,0 +1,222 @@
+#include "jobserver.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QLocale>
+#include <QTimer>
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace
+{
+
+#if defined(Q_OS_LINUX)
+
+// Reads a small /proc file into buffer, NUL-terminated
+bool readProcFile(const char *path, char *buffer, int size)
+{
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    const ssize_t count = ::read(fd, buffer, size_t(size - 1));
+    ::close(fd);
+    if (count < 0) return false;
+    buffer[count] = '\0';
+    return true;
+}
+
+qint64 memAvailableBytes()
+{
+    char buffer[4096];
+    if (!readProcFile("/proc/meminfo", buffer, sizeof(buffer))) return -1;
+    const char *field = std::strstr(buffer, "MemAvailable:");
+    if (!field) return -1;
+    return std::strtoll(field + 13, nullptr, 10) * 1024;
+}
+
+// "some avg10": share of the last 10 s in which some task waited on memory
+double memoryPressure()
+{
+    char buffer[256];
+    if (!readProcFile("/proc/pressure/memory", buffer, sizeof(buffer))) return 0;
+    const char *field = std::strstr(buffer, "some avg10=");
+    return field ? std::strtod(field + 11, nullptr) : 0;
+}
+
+#endif
+
+} // namespace
+
+JobServer::JobServer(QObject *parent)
+    : QObject(parent)
+    , timer(new QTimer(this))
+{
+    timer->setInterval(IntervalMs);
+    connect(timer, &QTimer::timeout, this, &JobServer::adjust);
+
+    // Roughly what one Qt compile job needs; linking the big modules needs more
+    const int perJobMb = qEnvironmentVariableIntValue("QT6_INSTALLER_JOB_MEMORY_MB");
+    perJobBytes = (perJobMb > 0 ? perJobMb : 1024) * 1024LL * 1024;
+}
+
+JobServer::~JobServer()
+{
+    close();
+}
+
+bool JobServer::isSupported()
+{
+#if defined(Q_OS_LINUX)
+    return qEnvironmentVariable("QT6_INSTALLER_JOBSERVER") != QLatin1String("0");
+#else
+    return false;
+#endif
+}
+
+bool JobServer::open(int maxJobs, QString *errorString)
+{
+    close();
+
+#if defined(Q_OS_LINUX)
+    path = QDir::temp().filePath(QString("qt6-installer-jobserver-%1").arg(QCoreApplication::applicationPid()));
+    const QByteArray nativePath = QFile::encodeName(path);
+    ::unlink(nativePath.constData());
+    if (::mkfifo(nativePath.constData(), 0600) != 0) {
+        if (errorString) *errorString = QString("mkfifo %1: %2").arg(path, QString::fromLocal8Bit(std::strerror(errno)));
+        return false;
+    }
+
+    // Read-write, so the FIFO never sees EOF while clients come and go
+    fd = ::open(nativePath.constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        if (errorString) *errorString = QString("open %1: %2").arg(path, QString::fromLocal8Bit(std::strerror(errno)));
+        ::unlink(nativePath.constData());
+        return false;
+    }
+
+    // The first limit is taken as is; later ones only grow slowly
+    maxLimit = qMax(1, maxJobs);
+    limit = 1;
+    issued = 0;
+    QString reason;
+    setLimit(targetJobs(&reason), reason);
+    timer->start();
+    return true;
+#else
+    Q_UNUSED(maxJobs);
+    if (errorString) *errorString = QString("not supported on this system");
+    return false;
+#endif
+}
+
+void JobServer::close()
+{
+#if defined(Q_OS_LINUX)
+    if (fd < 0) return;
+
+    timer->stop();
+    ::close(fd);
+    ::unlink(QFile::encodeName(path).constData());
+    fd = -1;
+    issued = 0;
+#endif
+}
+
+QString JobServer::makeflags() const
+{
+    // -j marks the build parallel; the slots themselves come from the FIFO
+    return QString("-j%1 --jobserver-auth=fifo:%2").arg(maxLimit).arg(path);
+}
+
+void JobServer::adjust()
+{
+#if defined(Q_OS_LINUX)
+    if (fd < 0) return;
+
+    reclaimTokens();
+
+    // Shrink at once, grow one job at a time
+    QString reason;
+    int target = targetJobs(&reason);
+    if (target > limit) target = limit + 1;
+    if (target != limit) {
+        setLimit(target, reason);
+    }
+#endif
+}
+
+int JobServer::targetJobs(QString *reason) const
+{
+#if defined(Q_OS_LINUX)
+    // Jobs running now already have their memory; more start only if it fits
+    const qint64 available = memAvailableBytes();
+    const int running = 1 + issued - tokensInPipe();
+    int target = available < 0 ? maxLimit : running + int(available / perJobBytes);
+    *reason = QString("%1 available").arg(QLocale::system().formattedDataSize(qMax<qint64>(0, available)));
+
+    const double pressure = memoryPressure();
+    if (pressure >= HighPressure) {
+        target = qMin(target, limit / 2);
+        *reason = QString("memory pressure %1%").arg(pressure, 0, 'f', 1);
+    } else if (pressure >= ModeratePressure) {
+        target = qMin(target, limit - 1);
+        *reason = QString("memory pressure %1%").arg(pressure, 0, 'f', 1);
+    }
+    return qBound(1, target, maxLimit);
+#else
+    Q_UNUSED(reason);
+    return 1;
+#endif
+}
+
+void JobServer::setLimit(int jobs, const QString &reason)
+{
+#if defined(Q_OS_LINUX)
+    limit = jobs;
+
+    // The build holds one implicit slot, so the FIFO carries limit - 1 tokens
+    while (issued < limit - 1) {
+        if (::write(fd, "+", 1) != 1) break;
+        ++issued;
+    }
+    reclaimTokens();
+    emit limitChanged(limit, reason);
+#else
+    Q_UNUSED(jobs);
+    Q_UNUSED(reason);
+#endif
+}
+
+void JobServer::reclaimTokens()
+{
+#if defined(Q_OS_LINUX)
+    // Tokens held by running jobs come back as they finish; take them then
+    char tokens[64];
+    while (issued > limit - 1) {
+        const int wanted = qMin<int>(issued - (limit - 1), int(sizeof(tokens)));
+        const ssize_t count = ::read(fd, tokens, size_t(wanted));
+        if (count <= 0) break;
+        issued -= int(count);
+    }
+#endif
+}
+
+int JobServer::tokensInPipe() const
+{
+#if defined(Q_OS_LINUX)
+    int count = 0;
+    if (::ioctl(fd, FIONREAD, &count) != 0) return 0;
+    return count;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,65 @@
+#ifndef JOBSERVER_H
+#define JOBSERVER_H
+
+#include <QObject>
+#include <QString>
+
+class QTimer;
+
+// A GNU make compatible jobserver whose job count follows memory pressure.
+//
+// The job slots are tokens in a named FIFO, passed to the build as
+// "--jobserver-auth=fifo:<path>" in MAKEFLAGS; make and ninja 1.13+ take a
+// token before starting a job and put it back when it ends. Every second
+// the limit is recomputed from MemAvailable (the jobs already running plus
+// as many more as fit in PerJobBytes each) and cut back when
+// /proc/pressure/memory shows the system stalling on memory. Tokens are
+// added when the limit grows, at most one a second, and read back out of
+// the FIFO as they are returned when it shrinks. Linux only; lives on the
+// worker thread.
+class JobServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit JobServer(QObject *parent = nullptr);
+    ~JobServer();
+
+    // Off on other systems, or when QT6_INSTALLER_JOBSERVER=0
+    static bool isSupported();
+
+    bool open(int maxJobs, QString *errorString = nullptr);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    // For the build's environment
+    QString makeflags() const;
+
+    int jobLimit() const { return limit; }
+
+signals:
+    void limitChanged(int jobs, const QString &reason);
+
+private slots:
+    void adjust();
+
+private:
+    static constexpr int IntervalMs = 1000;
+    static constexpr double ModeratePressure = 5;   // % of time stalled on memory (avg10)
+    static constexpr double HighPressure = 20;
+
+    int targetJobs(QString *reason) const;
+    void setLimit(int jobs, const QString &reason);
+    void reclaimTokens();
+    int tokensInPipe() const;
+
+    QTimer *timer;
+    QString path;
+    qint64 perJobBytes;
+    int fd = -1;
+    int maxLimit = 1;
+    int limit = 1;
+    int issued = 0;     // tokens handed out beyond the build's implicit one
+};
+
+#endif // JOBSERVER_H
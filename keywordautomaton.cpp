@@ -0,0 +1,71 @@
+#include "keywordautomaton.h"
+
+#include <deque>
+
+int KeywordAutomaton::addKeyword(const std::string &keyword)
+{
+    if (keyword.empty() || int(keywords.size()) >= MaxKeywords) return -1;
+    keywords.push_back(keyword);
+    return int(keywords.size()) - 1;
+}
+
+void KeywordAutomaton::clear()
+{
+    keywords.clear();
+    transitions.clear();
+    outputs.clear();
+}
+
+void KeywordAutomaton::build()
+{
+    constexpr std::uint32_t None = UINT32_MAX;
+
+    // Trie with unset edges; state 0 is the root
+    transitions.assign(256, None);
+    outputs.assign(1, 0);
+
+    for (std::size_t k = 0; k < keywords.size(); ++k) {
+        std::uint32_t state = 0;
+        for (unsigned char c : keywords[k]) {
+            std::uint32_t &next = transitions[state * 256 + c];
+            if (next == None) {
+                next = std::uint32_t(outputs.size());
+                outputs.push_back(0);
+                transitions.resize(transitions.size() + 256, None);
+            }
+            state = transitions[state * 256 + c];
+        }
+        outputs[state] |= std::uint64_t(1) << k;
+    }
+
+    // Breadth-first: complete every state's row from its failure state's row
+    std::vector<std::uint32_t> failure(outputs.size(), 0);
+    std::deque<std::uint32_t> queue;
+
+    for (int c = 0; c < 256; ++c) {
+        std::uint32_t &next = transitions[c];
+        if (next == None) {
+            next = 0;
+        } else {
+            failure[next] = 0;
+            queue.push_back(next);
+        }
+    }
+
+    while (!queue.empty()) {
+        const std::uint32_t state = queue.front();
+        queue.pop_front();
+        outputs[state] |= outputs[failure[state]];
+
+        for (int c = 0; c < 256; ++c) {
+            std::uint32_t &next = transitions[state * 256 + c];
+            const std::uint32_t fallback = transitions[failure[state] * 256 + c];
+            if (next == None) {
+                next = fallback;
+            } else {
+                failure[next] = fallback;
+                queue.push_back(next);
+            }
+        }
+    }
+}
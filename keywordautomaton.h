@@ -0,0 +1,47 @@
+#ifndef KEYWORDAUTOMATON_H
+#define KEYWORDAUTOMATON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Aho-Corasick automaton over bytes for up to 64 keywords.
+//
+// build() turns the keyword trie into a dense DFA (256 transitions per
+// state, failure links folded in) and gives every state the bitmask of the
+// keywords that end there, including those reached through its suffix
+// links. Matching a line is then one table lookup and one OR per byte,
+// however many keywords there are.
+class KeywordAutomaton
+{
+public:
+    static constexpr int MaxKeywords = 64;
+
+    // Returns the keyword's bit index, or -1 if the table is full or the keyword empty
+    int addKeyword(const std::string &keyword);
+    void build();
+    void clear();
+
+    int keywordCount() const { return int(keywords.size()); }
+
+    // Bit i is set if keyword i occurs anywhere in [data, data + size)
+    std::uint64_t match(const char *data, std::size_t size) const
+    {
+        std::uint64_t found = 0;
+        std::uint32_t state = 0;
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            state = transitions[state * 256 + bytes[i]];
+            found |= outputs[state];
+        }
+        return found;
+    }
+
+private:
+    std::vector<std::string> keywords;
+    std::vector<std::uint32_t> transitions;     // state * 256 + byte -> state
+    std::vector<std::uint64_t> outputs;         // keywords ending in each state
+};
+
+#endif // KEYWORDAUTOMATON_H
@@ -0,0 +1,187 @@
+#include "lineclassifier.h"
+
+#include <QFile>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include <QtAlgorithms>
+
+namespace
+{
+
+bool parseLineClass(const QString &name, LineClass *lineClass)
+{
+    static const struct { const char *name; LineClass lineClass; } classes[] = {
+        {"plain", LineClass::Plain},
+        {"info", LineClass::Info},
+        {"success", LineClass::Success},
+        {"warning", LineClass::Warning},
+        {"error", LineClass::Error},
+        {"section", LineClass::Section},
+        {"detail", LineClass::Detail},
+        {"stderr", LineClass::Stderr},
+    };
+    for (const auto &entry : classes) {
+        if (name.compare(QLatin1String(entry.name), Qt::CaseInsensitive) == 0) {
+            *lineClass = entry.lineClass;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+LineClassifier::LineClassifier()
+{
+    rebuild(builtinRules(), nullptr);
+}
+
+QList<LineClassifier::Rule> LineClassifier::builtinRules()
+{
+    return {
+        // Color rules, in order of precedence
+        {"[INFO]", LineClass::Info},
+        {"Building", LineClass::Info},
+        {"Configuring", LineClass::Info},
+        {"[SUCCESS]", LineClass::Success},
+        {"successfully", LineClass::Success},
+        {"Complete", LineClass::Success},
+        {"[WARNING]", LineClass::Warning},
+        {"[ERROR]", LineClass::Error},
+        {"error:", LineClass::Error},
+        {"Error", LineClass::Error},
+        {"===", LineClass::Section},
+
+        // Simple progress estimation based on output keywords
+        {"Checking prerequisites", LineClass::Plain, 5},
+        {"llvm-mingw", LineClass::Plain, 10},
+        {"Qt6 source", LineClass::Plain, 15},
+        {"Configuring Qt6 host", LineClass::Plain, 20},
+        {"Building Qt6 host", LineClass::Plain, 30},
+        {"Installing Qt6 host", LineClass::Plain, 50},
+        {"Configuring Qt6 Windows", LineClass::Plain, 55},
+        {"Building Qt6 Windows", LineClass::Plain, 70},
+        {"Installing Qt6 Windows", LineClass::Plain, 85},
+        {"Qt6 QML modules", LineClass::Plain, 88},
+        {"test application", LineClass::Plain, 95},
+        {"Installation Complete", LineClass::Plain, 100},
+    };
+}
+
+const QList<QByteArray> &LineClassifier::diagnosticHints()
+{
+    static const QList<QByteArray> hints = {
+        " warning: ",
+        " error: ",
+        "CMake Error",
+        "CMake Warning",
+        "CMake Deprecation Warning",
+    };
+    return hints;
+}
+
+bool LineClassifier::loadRules(const QString &path, QString *errorString)
+{
+    QFile file(path);
+    if (!file.exists()) return true;
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+
+    // color <class> <keyword...>  |  progress <percent> <keyword...>
+    static const QRegularExpression rulePattern(QStringLiteral("^(\\S+)\\s+(\\S+)\\s+(.+)$"));
+
+    QList<Rule> rules;
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        ++lineNumber;
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        if (line.isEmpty() || line.startsWith('#')) continue;
+
+        const QRegularExpressionMatch match = rulePattern.match(line);
+        Rule rule;
+        bool ok = match.hasMatch();
+        if (ok) {
+            rule.keyword = match.captured(3).toUtf8();
+            if (match.captured(1) == QLatin1String("color")) {
+                ok = parseLineClass(match.captured(2), &rule.lineClass);
+            } else if (match.captured(1) == QLatin1String("progress")) {
+                rule.progress = match.captured(2).toInt(&ok);
+                ok = ok && rule.progress >= 0 && rule.progress <= 100;
+            } else {
+                ok = false;
+            }
+        }
+
+        if (!ok) {
+            if (errorString) *errorString = QString("%1:%2: invalid rule \"%3\"").arg(path).arg(lineNumber).arg(line);
+            return false;
+        }
+        rules.append(rule);
+    }
+
+    return rebuild(rules + builtinRules(), errorString);
+}
+
+bool LineClassifier::rebuild(const QList<Rule> &rules, QString *errorString)
+{
+    const qsizetype maxRules = KeywordAutomaton::MaxKeywords - diagnosticHints().size();
+    if (rules.size() > maxRules) {
+        if (errorString) *errorString = QString("too many rules (%1, at most %2)").arg(rules.size()).arg(maxRules);
+        return false;
+    }
+
+    automaton.clear();
+    colorMask = 0;
+    progressMask = 0;
+    diagnosticMask = 0;
+    for (const Rule &rule : rules) {
+        const int bit = automaton.addKeyword(rule.keyword.toStdString());
+        if (rule.progress >= 0) {
+            progressMask |= quint64(1) << bit;
+        } else {
+            colorMask |= quint64(1) << bit;
+        }
+    }
+    for (const QByteArray &hint : diagnosticHints()) {
+        diagnosticMask |= quint64(1) << automaton.addKeyword(hint.toStdString());
+    }
+    automaton.build();
+    ruleTable = rules;
+    return true;
+}
+
+LineClassifier::Result LineClassifier::classify(QByteArrayView line) const
+{
+    const quint64 found = automaton.match(line.data(), size_t(line.size()));
+
+    // Lower bits come first in the table, so the lowest set bit wins
+    Result result;
+    if (const quint64 colors = found & colorMask) {
+        result.lineClass = ruleTable.at(qCountTrailingZeroBits(colors)).lineClass;
+    }
+    if (const quint64 milestones = found & progressMask) {
+        result.progress = ruleTable.at(qCountTrailingZeroBits(milestones)).progress;
+    }
+    result.maybeDiagnostic = found & diagnosticMask;
+    return result;
+}
+
+QList<int> LineClassifier::milestones() const
+{
+    QList<int> values;
+    for (const Rule &rule : ruleTable) {
+        if (rule.progress >= 0) values.append(rule.progress);
+    }
+    return values;
+}
+
+QString LineClassifier::defaultRulesPath()
+{
+    const QString overridePath = qEnvironmentVariable("QT6_INSTALLER_RULES");
+    if (!overridePath.isEmpty()) return overridePath;
+
+    return QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation)
+        + "/qt6-installer-gui/rules.conf";
+}
@@ -0,0 +1,63 @@
+#ifndef LINECLASSIFIER_H
+#define LINECLASSIFIER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+
+#include "keywordautomaton.h"
+#include "logline.h"
+
+// Rule table used to color output lines and estimate progress.
+//
+// Every color rule and progress keyword is compiled into one
+// KeywordAutomaton, so a line is matched against the whole table in a
+// single pass. Rules are ordered: the first matching color rule picks the
+// line's class and the first matching progress rule its milestone. Rules
+// loaded from a file are placed ahead of the built-in ones. A few fixed
+// keywords also flag lines that may be compiler or CMake diagnostics, so
+// only those are handed to DiagnosticParser.
+class LineClassifier
+{
+public:
+    struct Result
+    {
+        LineClass lineClass = LineClass::Plain;
+        int progress = -1;      // milestone (0-100), or -1 if none matched
+        bool maybeDiagnostic = false;
+    };
+
+    LineClassifier();
+
+    // A missing file is not an error; a malformed one leaves the table unchanged
+    bool loadRules(const QString &path, QString *errorString = nullptr);
+
+    Result classify(QByteArrayView line) const;
+
+    // Progress values of all milestone rules, in table order
+    QList<int> milestones() const;
+
+    // $QT6_INSTALLER_RULES, or rules.conf in the user's config directory
+    static QString defaultRulesPath();
+
+private:
+    struct Rule
+    {
+        QByteArray keyword;
+        LineClass lineClass = LineClass::Plain;
+        int progress = -1;      // -1 for color rules
+    };
+
+    static QList<Rule> builtinRules();
+    static const QList<QByteArray> &diagnosticHints();
+    bool rebuild(const QList<Rule> &rules, QString *errorString);
+
+    KeywordAutomaton automaton;
+    QList<Rule> ruleTable;      // indexed by keyword bit
+    quint64 colorMask = 0;
+    quint64 progressMask = 0;
+    quint64 diagnosticMask = 0;
+};
+
+#endif // LINECLASSIFIER_H
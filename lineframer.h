@@ -0,0 +1,101 @@
+#ifndef LINEFRAMER_H
+#define LINEFRAMER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringDecoder>
+#include <QStringView>
+
+// Splits one output channel into whole lines across read boundaries.
+//
+// Framing is done on raw bytes: a '\n' byte never occurs inside a UTF-8
+// sequence, so a line (or a character) that straddles two reads is simply
+// carried over until its newline arrives. Complete lines are handed to the
+// sink as a view into the read buffer whenever possible; only the carried
+// part is ever copied. Newlines are found with QByteArrayView::indexOf,
+// which is the C library's vectorized memchr.
+// decode() runs a line through a stateful QStringDecoder into a reused
+// buffer for consumers that need UTF-16.
+class LineFramer
+{
+public:
+    // A line that never ends (e.g. a progress meter) is cut at this size
+    static constexpr qsizetype MaxLineLength = 1024 * 1024;
+
+    // sink(QByteArrayView bytes) is called once per line; the view excludes
+    // the line terminator and does not outlive the call.
+    template <typename Sink>
+    void feed(QByteArrayView data, Sink &&sink)
+    {
+        while (!data.isEmpty()) {
+            const qsizetype end = data.indexOf('\n');
+            if (end < 0) {
+                partial.append(data.data(), data.size());
+                if (partial.size() >= MaxLineLength) {
+                    emitCarried(sink);
+                }
+                return;
+            }
+
+            const QByteArrayView head = data.first(end);
+            if (partial.isEmpty()) {
+                emitLine(head, sink);
+            } else {
+                partial.append(head.data(), head.size());
+                emitCarried(sink);
+            }
+            data = data.sliced(end + 1);
+        }
+    }
+
+    // Emits a trailing line that was never terminated
+    template <typename Sink>
+    void finish(Sink &&sink)
+    {
+        if (!partial.isEmpty()) {
+            emitCarried(sink);
+        }
+    }
+
+    void reset()
+    {
+        partial.truncate(0);
+        decoder.resetState();
+    }
+
+    // The returned view is valid until the next call to decode()
+    QStringView decode(QByteArrayView line)
+    {
+        text.resize(decoder.requiredSpace(line.size()));
+        QChar *end = decoder.appendToBuffer(text.data(), line);
+        text.resize(end - text.constData());
+        return QStringView(text);
+    }
+
+private:
+    template <typename Sink>
+    void emitCarried(Sink &sink)
+    {
+        emitLine(partial, sink);
+        partial.truncate(0);
+    }
+
+    template <typename Sink>
+    void emitLine(QByteArrayView line, Sink &sink)
+    {
+        if (line.endsWith('\r')) line.chop(1);
+
+        // A bare carriage return rewrites the line on a terminal; keep what would be visible
+        const qsizetype carriageReturn = line.lastIndexOf('\r');
+        if (carriageReturn >= 0) line = line.sliced(carriageReturn + 1);
+
+        sink(line);
+    }
+
+    QByteArray partial;
+    QStringDecoder decoder{QStringDecoder::Utf8};
+    QString text;
+};
+
+#endif // LINEFRAMER_H
@@ -0,0 +1,58 @@
+#include "logdelegate.h"
+
+#include <QApplication>
+#include <QPainter>
+
+#include "logfiltermodel.h"
+#include "logmodel.h"
+
+void LogDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    // Filtered views paint the source row
+    const LogModel *model = qobject_cast<const LogModel *>(index.model());
+    int row = index.row();
+    if (const LogFilterModel *filter = qobject_cast<const LogFilterModel *>(index.model())) {
+        model = filter->sourceModel();
+        row = filter->sourceRow(row);
+    }
+
+    if (!model || !model->hasSpans(row)) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    // Let the style draw background and selection, then the text run by run
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+    opt.text.clear();
+
+    const QWidget *widget = opt.widget;
+    QStyle *style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+    const QRect textRect = style->subElementRect(QStyle::SE_ItemViewItemText, &opt, widget);
+    const QColor defaultColor = opt.palette.color(
+        opt.state & QStyle::State_Selected ? QPalette::HighlightedText : QPalette::Text);
+
+    painter->save();
+    painter->setClipRect(textRect);
+
+    const QFontMetrics metrics(opt.font);
+    const int baseline = textRect.top() + (textRect.height() - metrics.height()) / 2 + metrics.ascent();
+    int x = textRect.left() + style->pixelMetric(QStyle::PM_FocusFrameHMargin, nullptr, widget) + 1;
+
+    for (const LogModel::Segment &segment : model->segments(row)) {
+        QFont font = opt.font;
+        font.setBold(segment.bold);
+        font.setUnderline(segment.underline);
+
+        painter->setFont(font);
+        painter->setPen(segment.color.isValid() ? segment.color : defaultColor);
+        painter->drawText(QPoint(x, baseline), segment.text);
+
+        x += QFontMetrics(font).horizontalAdvance(segment.text);
+        if (x > textRect.right()) break;
+    }
+
+    painter->restore();
+}
@@ -0,0 +1,18 @@
+#ifndef LOGDELEGATE_H
+#define LOGDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+// Paints log rows that carry ANSI style spans run by run; every other row
+// is left to QStyledItemDelegate and its class color.
+class LogDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+#endif // LOGDELEGATE_H
@@ -0,0 +1,186 @@
+#include "logfileloader.h"
+
+#include <QFile>
+#include <QThreadPool>
+
+#include <atomic>
+#include <cstring>
+
+#include "ansiparser.h"
+#include "lineclassifier.h"
+#include "lineframer.h"
+#include "logwriter.h"
+
+// Shared with the parsing tasks, so the mapping outlives a cancelled load
+struct LogFileLoader::Load
+{
+    QFile file;
+    const char *data = nullptr;
+    qint64 size = 0;
+    bool sessionFormat = false;
+    LineClassifier classifier;
+    std::atomic<bool> cancelled{false};
+};
+
+LogFileLoader::LogFileLoader(QObject *parent)
+    : QObject(parent)
+{
+    maxInFlight = qMax(2, pool.maxThreadCount() * 2);
+}
+
+LogFileLoader::~LogFileLoader()
+{
+    cancel();
+    pool.waitForDone();
+}
+
+bool LogFileLoader::open(const QString &path, QString *errorString)
+{
+    cancel();
+
+    auto state = std::make_shared<Load>();
+    state->file.setFileName(path);
+    if (!state->file.open(QIODevice::ReadOnly)) {
+        if (errorString) *errorString = state->file.errorString();
+        return false;
+    }
+
+    state->size = state->file.size();
+    if (state->size > 0) {
+        const uchar *mapped = state->file.map(0, state->size);
+        if (!mapped) {
+            if (errorString) *errorString = state->file.errorString();
+            return false;
+        }
+        state->data = reinterpret_cast<const char *>(mapped);
+    }
+
+    const QByteArrayView header(LogWriter::SessionHeader);
+    state->sessionFormat = QByteArrayView(state->data, state->size).startsWith(header);
+
+    // A broken rules file is reported by live runs; here the built-ins still apply
+    state->classifier.loadRules(LineClassifier::defaultRulesPath());
+
+    load = state;
+    parsed.clear();
+    diagnostics.clear();
+    nextBegin = 0;
+    nextChunk = 0;
+    nextDelivery = 0;
+    bytesLoaded = 0;
+    nextSequence = 0;
+
+    // Signals only ever come from the event loop, never from inside open()
+    QMetaObject::invokeMethod(this, &LogFileLoader::dispatch, Qt::QueuedConnection);
+    return true;
+}
+
+void LogFileLoader::cancel()
+{
+    if (!load) return;
+
+    // Running tasks finish their chunk; their results are dropped
+    load->cancelled.store(true, std::memory_order_relaxed);
+    load.reset();
+    parsed.clear();
+}
+
+LogFileLoader::Chunk LogFileLoader::parseChunk(const Load &load, qint64 begin, qint64 end)
+{
+    Chunk chunk;
+    chunk.bytes = end - begin;
+
+    // Escape state does not carry over from the previous chunk
+    LineFramer framer;
+    AnsiParser ansi;
+    QByteArray stripped;
+
+    auto sink = [&](QByteArrayView bytes) {
+        LogLine line;
+        if (load.sessionFormat) {
+            LogWriter::parseLine(&bytes, &line.timestampUs, &line.channel);
+        }
+
+        if (ansi.process(bytes, &stripped, &line.spans)) {
+            bytes = stripped;
+        }
+
+        const LineClassifier::Result result = load.classifier.classify(bytes);
+        if (line.channel == LogChannel::Stderr) {
+            line.lineClass = LineClass::Stderr;
+        } else {
+            line.lineClass = result.lineClass;
+            line.progress = result.progress;
+        }
+        if (result.maybeDiagnostic) {
+            chunk.diagnosticCandidates.append(int(chunk.lines.size()));
+        }
+
+        line.text = bytes.toByteArray();
+        chunk.lines.append(std::move(line));
+    };
+
+    framer.feed(QByteArrayView(load.data + begin, end - begin), sink);
+    framer.finish(sink);
+    return chunk;
+}
+
+void LogFileLoader::dispatch()
+{
+    if (!load) return;
+
+    while (nextBegin < load->size && nextChunk - nextDelivery < maxInFlight) {
+        // Extend every chunk to the end of its last line, so none is split
+        const qint64 begin = nextBegin;
+        qint64 end = qMin(load->size, begin + (nextChunk == 0 ? FirstChunkSize : ChunkSize));
+        if (end < load->size) {
+            const void *newline = std::memchr(load->data + end, '\n', size_t(load->size - end));
+            end = newline ? static_cast<const char *>(newline) - load->data + 1 : load->size;
+        }
+
+        const std::shared_ptr<Load> state = load;
+        const int index = nextChunk++;
+        nextBegin = end;
+
+        pool.start([this, state, index, begin, end]() {
+            if (state->cancelled.load(std::memory_order_relaxed)) return;
+            Chunk chunk = parseChunk(*state, begin, end);
+            QMetaObject::invokeMethod(this, [this, state, index, chunk = std::move(chunk)]() mutable {
+                chunkParsed(state, index, std::move(chunk));
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    if (nextBegin >= load->size && nextDelivery == nextChunk) {
+        load.reset();
+        emit finished();
+    }
+}
+
+void LogFileLoader::chunkParsed(const std::shared_ptr<Load> &source, int index, Chunk chunk)
+{
+    if (source != load) return;
+    parsed.insert(index, std::move(chunk));
+
+    // Hand chunks out in file order, whatever order they finished in
+    while (load && !parsed.isEmpty() && parsed.firstKey() == nextDelivery) {
+        Chunk next = parsed.take(nextDelivery++);
+
+        // Sequence numbers and diagnostic ids depend on everything before
+        for (LogLine &line : next.lines) {
+            line.sequence = nextSequence++;
+        }
+        for (const int candidate : next.diagnosticCandidates) {
+            LogLine &line = next.lines[candidate];
+            line.diagnostic = diagnostics.intern(line.text);
+        }
+
+        bytesLoaded += next.bytes;
+        emit linesLoaded(next.lines);
+        if (load) {
+            emit progressChanged(bytesLoaded, load->size);
+        }
+    }
+
+    dispatch();
+}
@@ -0,0 +1,74 @@
+#ifndef LOGFILELOADER_H
+#define LOGFILELOADER_H
+
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+#include <memory>
+
+#include "diagnosticparser.h"
+#include "logline.h"
+
+// Loads a saved log file into the same line stream a live run produces.
+//
+// The file is memory-mapped and cut into chunks that end on a newline, so
+// no line straddles two chunks. Chunks are framed, stripped of escapes and
+// classified in parallel on a private thread pool, then handed out strictly
+// in file order through linesLoaded(); the small first chunk lets the view
+// show something long before the whole file is parsed. Only a bounded
+// window of chunks is in flight at a time, which keeps memory flat for
+// multi-gigabyte files. Session logs written by LogWriter get their
+// timestamps and channels back.
+//
+// Lives on the GUI thread; signals are emitted from its event loop.
+class LogFileLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qsizetype FirstChunkSize = 256 * 1024;
+    static constexpr qsizetype ChunkSize = 8 * 1024 * 1024;
+
+    explicit LogFileLoader(QObject *parent = nullptr);
+    ~LogFileLoader();
+
+    bool open(const QString &path, QString *errorString = nullptr);
+    void cancel();
+    bool isLoading() const { return bool(load); }
+
+signals:
+    void linesLoaded(const LogLineBatch &lines);
+    void progressChanged(qint64 bytesLoaded, qint64 bytesTotal);
+    void finished();
+
+private:
+    struct Load;
+
+    struct Chunk
+    {
+        LogLineBatch lines;
+        QList<int> diagnosticCandidates;    // lines that may be diagnostics
+        qint64 bytes = 0;
+    };
+
+    static Chunk parseChunk(const Load &load, qint64 begin, qint64 end);
+
+    void dispatch();
+    void chunkParsed(const std::shared_ptr<Load> &source, int index, Chunk chunk);
+
+    QThreadPool pool;
+    std::shared_ptr<Load> load;
+    QMap<int, Chunk> parsed;        // finished out of order, waiting for their turn
+    DiagnosticParser diagnostics;
+    qint64 nextBegin = 0;
+    int nextChunk = 0;
+    int nextDelivery = 0;
+    qint64 bytesLoaded = 0;
+    quint64 nextSequence = 0;
+    int maxInFlight = 1;
+};
+
+#endif // LOGFILELOADER_H
@@ -0,0 +1,85 @@
+#include "logfiltermodel.h"
+
+#include "logmodel.h"
+
+LogFilterModel::LogFilterModel(LogModel *source, QObject *parent)
+    : QAbstractListModel(parent)
+    , source(source)
+{
+    connect(source, &QAbstractItemModel::rowsInserted, this, &LogFilterModel::sourceRowsInserted);
+    connect(source, &QAbstractItemModel::modelReset, this, &LogFilterModel::sourceReset);
+    connect(source, &QAbstractItemModel::dataChanged, this, &LogFilterModel::sourceDataChanged);
+    shownRows = availableRows();
+}
+
+int LogFilterModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return shownRows;
+}
+
+QVariant LogFilterModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= shownRows) return QVariant();
+    return source->data(source->index(sourceRow(index.row())), role);
+}
+
+void LogFilterModel::setClassFilter(LineClass lineClass)
+{
+    beginResetModel();
+    filter = Filter::Class;
+    filterClass = lineClass;
+    shownRows = availableRows();
+    endResetModel();
+}
+
+void LogFilterModel::setPhaseFilter(int phase)
+{
+    beginResetModel();
+    filter = Filter::Phase;
+    filterPhase = phase;
+    shownRows = availableRows();
+    endResetModel();
+}
+
+int LogFilterModel::sourceRow(int row) const
+{
+    if (filter == Filter::Class) {
+        return source->rowsOfClass(filterClass).at(row);
+    }
+    return source->phases().at(filterPhase).firstRow + row;
+}
+
+void LogFilterModel::sourceRowsInserted()
+{
+    // The source only ever appends, so new matches always go at the end
+    const int rows = availableRows();
+    if (rows <= shownRows) return;
+
+    beginInsertRows(QModelIndex(), shownRows, rows - 1);
+    shownRows = rows;
+    endInsertRows();
+}
+
+void LogFilterModel::sourceReset()
+{
+    beginResetModel();
+    shownRows = availableRows();
+    endResetModel();
+}
+
+void LogFilterModel::sourceDataChanged()
+{
+    if (shownRows > 0) {
+        emit dataChanged(index(0), index(shownRows - 1));
+    }
+}
+
+int LogFilterModel::availableRows() const
+{
+    if (filter == Filter::Class) {
+        return int(source->rowsOfClass(filterClass).size());
+    }
+    if (filterPhase >= source->phases().size()) return 0;
+    return source->phaseEnd(filterPhase) - source->phases().at(filterPhase).firstRow;
+}
@@ -0,0 +1,52 @@
+#ifndef LOGFILTERMODEL_H
+#define LOGFILTERMODEL_H
+
+#include <QAbstractListModel>
+
+#include "logline.h"
+
+class LogModel;
+
+// Live view of the rows of one line class or one install phase.
+//
+// Rows come straight from LogModel's posting lists or phase ranges, so
+// switching the filter is a reset and each appended source row costs O(1);
+// nothing is ever rescanned.
+class LogFilterModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit LogFilterModel(LogModel *source, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setClassFilter(LineClass lineClass);
+    void setPhaseFilter(int phase);
+
+    LogModel *sourceModel() const { return source; }
+    int sourceRow(int row) const;
+
+private slots:
+    void sourceRowsInserted();
+    void sourceReset();
+    void sourceDataChanged();
+
+private:
+    enum class Filter
+    {
+        Class,
+        Phase
+    };
+
+    int availableRows() const;
+
+    LogModel *source;
+    Filter filter = Filter::Class;
+    LineClass filterClass = LineClass::Error;
+    int filterPhase = 0;
+    int shownRows = 0;
+};
+
+#endif // LOGFILTERMODEL_H
@@ -0,0 +1,57 @@
+#ifndef LOGLINE_H
+#define LOGLINE_H
+
+#include <QByteArray>
+#include <QList>
+
+// Classification of a single output line, decided once at ingestion
+enum class LineClass : quint8
+{
+    Plain,
+    Info,
+    Success,
+    Warning,
+    Error,
+    Section,
+    Detail,
+    Stderr
+};
+
+// Where a line came from; Installer lines are the GUI's own messages
+enum class LogChannel : quint8
+{
+    Stdout,
+    Stderr,
+    Installer
+};
+
+// Styled run inside a line, as set by ANSI SGR escapes; offsets are in bytes
+struct StyleSpan
+{
+    quint32 start = 0;
+    quint32 length = 0;
+    quint32 style = 0;      // see AnsiParser for the bit layout
+};
+
+using StyleSpans = QList<StyleSpan>;
+
+// One framed output line; text is UTF-8 without the trailing newline or
+// any escape sequences, spans only cover runs with a non-default style.
+// sequence orders lines across both channels; timestampUs is the arrival
+// time on the session's monotonic clock. progress is the milestone this line
+// announces, or -1; diagnostic is its DiagnosticParser id, or -1.
+struct LogLine
+{
+    QByteArray text;
+    LineClass lineClass = LineClass::Plain;
+    StyleSpans spans;
+    LogChannel channel = LogChannel::Stdout;
+    quint64 sequence = 0;
+    qint64 timestampUs = 0;
+    int progress = -1;
+    int diagnostic = -1;
+};
+
+using LogLineBatch = QList<LogLine>;
+
+#endif // LOGLINE_H
@@ -0,0 +1,188 @@
+#include "logmodel.h"
+
+#include "ansiparser.h"
+#include "sessionclock.h"
+
+namespace {
+
+const char *channelName(LogChannel channel)
+{
+    switch (channel) {
+    case LogChannel::Stdout:    return "stdout";
+    case LogChannel::Stderr:    return "stderr";
+    case LogChannel::Installer: return "installer";
+    }
+    return "";
+}
+
+} // namespace
+
+LogModel::LogModel(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return int(logStore.lineCount());
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= logStore.lineCount()) return QVariant();
+
+    switch (role) {
+    case Qt::DisplayRole:
+        if (timestampsShown) return timestampPrefix(index.row()) + lineText(index.row());
+        return lineText(index.row());
+    case Qt::ToolTipRole:
+        return toolTip(index.row());
+    case Qt::ForegroundRole:
+        // The script's own colors win; keyword classes are the fallback
+        if (logStore.hasSpans(index.row())) return QVariant();
+        return colorFor(logStore.lineClass(index.row()));
+    default:
+        return QVariant();
+    }
+}
+
+void LogModel::appendLines(const LogLineBatch &lines)
+{
+    if (lines.isEmpty()) return;
+
+    const int first = int(logStore.lineCount());
+    const qsizetype phaseCount = phaseList.size();
+    if (phaseList.isEmpty()) {
+        phaseList.append({0, 0, QString("Startup")});
+    }
+
+    beginInsertRows(QModelIndex(), first, first + int(lines.size()) - 1);
+    int row = first;
+    for (const LogLine &line : lines) {
+        logStore.append(line);
+        classRows[int(line.lineClass)].append(row);
+
+        // Same rule as the progress bar: only a higher milestone starts a phase
+        if (line.progress > phaseList.last().progress) {
+            phaseList.append({row, line.progress, QString::fromUtf8(line.text).trimmed()});
+        }
+        ++row;
+    }
+    endInsertRows();
+
+    if (phaseList.size() != phaseCount) {
+        emit phasesChanged();
+    }
+}
+
+void LogModel::clear()
+{
+    beginResetModel();
+    logStore.clear();
+    for (QList<int> &rows : classRows) {
+        rows.clear();
+    }
+    phaseList.clear();
+    endResetModel();
+
+    emit phasesChanged();
+}
+
+int LogModel::phaseEnd(int phase) const
+{
+    return phase + 1 < phaseList.size() ? phaseList.at(phase + 1).firstRow : int(logStore.lineCount());
+}
+
+void LogModel::setShowTimestamps(bool show)
+{
+    if (timestampsShown == show) return;
+    timestampsShown = show;
+
+    if (logStore.lineCount() > 0) {
+        emit dataChanged(index(0), index(int(logStore.lineCount()) - 1), {Qt::DisplayRole});
+    }
+}
+
+QString LogModel::lineText(int row) const
+{
+    return QString::fromUtf8(logStore.line(row));
+}
+
+LineClass LogModel::lineClass(int row) const
+{
+    return logStore.lineClass(row);
+}
+
+bool LogModel::hasSpans(int row) const
+{
+    return logStore.hasSpans(row);
+}
+
+QList<LogModel::Segment> LogModel::segments(int row) const
+{
+    QList<Segment> result;
+    if (timestampsShown) {
+        result.append({timestampPrefix(row), colorFor(LineClass::Detail)});
+    }
+
+    // Copy the spans first: reading the text may remap the chunk
+    const StyleSpans spans = logStore.spans(row);
+    const QByteArrayView bytes = logStore.line(row);
+
+    auto addSegment = [&](qsizetype begin, qsizetype end, quint32 style) {
+        begin = qBound(qsizetype(0), begin, bytes.size());
+        end = qBound(begin, end, bytes.size());
+        if (begin == end) return;
+
+        Segment segment;
+        segment.text = QString::fromUtf8(bytes.sliced(begin, end - begin));
+        if (style & AnsiParser::HasColor) segment.color = QColor::fromRgb(style & AnsiParser::ColorMask);
+        segment.bold = style & AnsiParser::Bold;
+        segment.underline = style & AnsiParser::Underline;
+        result.append(segment);
+    };
+
+    qsizetype position = 0;
+    for (const StyleSpan &span : spans) {
+        addSegment(position, span.start, 0);
+        addSegment(span.start, qsizetype(span.start) + span.length, span.style);
+        position = qsizetype(span.start) + span.length;
+    }
+    addSegment(position, bytes.size(), 0);
+    return result;
+}
+
+QString LogModel::timestampPrefix(int row) const
+{
+    const qint64 timestampUs = logStore.timestampUs(row);
+    const qint64 gapUs = row > 0 ? timestampUs - logStore.timestampUs(row - 1) : 0;
+
+    if (gapUs >= StallThresholdUs) {
+        return QString("[%1 +%2s] ").arg(SessionClock::formatElapsed(timestampUs)).arg(gapUs / 1000000.0, 0, 'f', 1);
+    }
+    return QString("[%1] ").arg(SessionClock::formatElapsed(timestampUs));
+}
+
+QString LogModel::toolTip(int row) const
+{
+    const QString header = QString("#%1 %2 at %3")
+        .arg(logStore.sequence(row))
+        .arg(channelName(logStore.channel(row)))
+        .arg(SessionClock::formatElapsed(logStore.timestampUs(row)));
+    return header + '\n' + lineText(row);
+}
+
+QColor LogModel::colorFor(LineClass lineClass)
+{
+    switch (lineClass) {
+    case LineClass::Info:    return Qt::blue;
+    case LineClass::Success: return Qt::darkGreen;
+    case LineClass::Warning: return QColor(255, 140, 0); // Orange
+    case LineClass::Error:   return Qt::red;
+    case LineClass::Section: return Qt::darkCyan;
+    case LineClass::Detail:  return Qt::darkGray;
+    case LineClass::Stderr:  return QColor(200, 0, 0); // Dark red for errors
+    case LineClass::Plain:   break;
+    }
+    return Qt::black;
+}
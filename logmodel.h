@@ -0,0 +1,89 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QColor>
+
+#include "logline.h"
+#include "logstore.h"
+
+// Flat list model over the installation log.
+//
+// Lines live in a LogStore as packed UTF-8, so memory follows the size of
+// the log (bounded by the store's hot window) and not the number of QStrings
+// or text blocks. Rows are only decoded when the view asks for them, which
+// keeps painting proportional to visible rows. With timestamps shown, each
+// row is prefixed with its arrival time, and a gap marker flags lines that
+// came after a long silence.
+//
+// For filtered views the model also keeps the rows of every line class in
+// posting lists, and splits the log into phases at each progress milestone,
+// so a filter is a list lookup or a row range rather than a scan.
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit LogModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // A run of text drawn in one style; an invalid color means the view's default
+    struct Segment
+    {
+        QString text;
+        QColor color;
+        bool bold = false;
+        bool underline = false;
+    };
+
+    void appendLines(const LogLineBatch &lines);
+    void clear();
+
+    // An install phase: the rows from one progress milestone to the next
+    struct Phase
+    {
+        int firstRow = 0;
+        int progress = 0;
+        QString title;
+    };
+
+    const QList<int> &rowsOfClass(LineClass lineClass) const { return classRows[int(lineClass)]; }
+    const QList<Phase> &phases() const { return phaseList; }
+    int phaseEnd(int phase) const;
+
+    void setShowTimestamps(bool show);
+    bool showTimestamps() const { return timestampsShown; }
+
+    QString lineText(int row) const;
+    LineClass lineClass(int row) const;
+
+    // Lines with ANSI styling are painted segment by segment
+    bool hasSpans(int row) const;
+    QList<Segment> segments(int row) const;
+
+    // Searched through LogSearch; lines are indexed by the store itself
+    LogStore &store() { return logStore; }
+
+    static QColor colorFor(LineClass lineClass);
+
+    // Silence before a line that gets it flagged as a stall
+    static constexpr qint64 StallThresholdUs = 5 * 1000 * 1000;
+
+signals:
+    void phasesChanged();
+
+private:
+    static constexpr int ClassCount = int(LineClass::Stderr) + 1;
+
+    QString timestampPrefix(int row) const;
+    QString toolTip(int row) const;
+
+    LogStore logStore;
+    QList<int> classRows[ClassCount];
+    QList<Phase> phaseList;
+    bool timestampsShown = false;
+};
+
+#endif // LOGMODEL_H
@@ -0,0 +1,387 @@
+#include "logsearch.h"
+
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+
+#include "logstore.h"
+
+namespace {
+
+bool isAscii(const QByteArray &bytes)
+{
+    return std::all_of(bytes.cbegin(), bytes.cend(), [](char c) { return uchar(c) < 0x80; });
+}
+
+char toAsciiLower(char c)
+{
+    return c >= 'A' && c <= 'Z' ? char(c - 'A' + 'a') : c;
+}
+
+char toAsciiUpper(char c)
+{
+    return c >= 'a' && c <= 'z' ? char(c - 'a' + 'A') : c;
+}
+
+// needle must be lowercase ASCII
+bool containsFolded(QByteArrayView haystack, const QByteArray &needle)
+{
+    const qsizetype size = needle.size();
+    if (size == 0) return true;
+    if (haystack.size() < size) return false;
+
+    // Jump between occurrences of the first byte in either case with memchr
+    const char lower = needle.at(0);
+    const char upper = toAsciiUpper(lower);
+    const char *position = haystack.data();
+    const char *end = haystack.data() + haystack.size() - size + 1;
+
+    while (position < end) {
+        const char *candidate = static_cast<const char *>(std::memchr(position, lower, end - position));
+        if (upper != lower) {
+            const char *limit = candidate ? candidate : end;
+            const char *other = static_cast<const char *>(std::memchr(position, upper, limit - position));
+            if (other) candidate = other;
+        }
+        if (!candidate) return false;
+
+        qsizetype i = 1;
+        while (i < size && toAsciiLower(candidate[i]) == needle.at(i)) ++i;
+        if (i == size) return true;
+        position = candidate + 1;
+    }
+    return false;
+}
+
+int rank(LineClass lineClass)
+{
+    switch (lineClass) {
+    case LineClass::Error:
+    case LineClass::Stderr:
+        return 0;
+    case LineClass::Warning:
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+bool isOctalDigit(QChar c)
+{
+    return c >= '0' && c <= '7';
+}
+
+bool isHexDigit(QChar c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// Index of the closing character of a {...} or <...> group that starts at from, or the last index
+qsizetype skipTo(const QString &pattern, qsizetype from, QChar close)
+{
+    const qsizetype end = pattern.indexOf(close, from);
+    return end < 0 ? pattern.size() - 1 : end;
+}
+
+// Returns the index of the last character of the escape that starts with
+// the backslash at i, or -1 for an escape we do not know the length of.
+// Only called for escapes whose first character is a letter or digit.
+qsizetype skipEscape(const QString &pattern, qsizetype i)
+{
+    const qsizetype size = pattern.size();
+    const QChar kind = pattern.at(i + 1);
+    qsizetype j = i + 2;
+    auto next = [&]() { return j < size ? pattern.at(j) : QChar(); };
+
+    // Single-character classes, assertions and control characters
+    const QLatin1String simple("dDwWsShHvVRXbBAzZGKtnrfaeE");
+    if (simple.contains(kind)) return i + 1;
+
+    if (kind.isDigit()) {
+        // \0 takes up to two more octal digits; \1 to \9 may be a back
+        // reference or an octal code, so all of the digits go with it
+        if (kind == '0') {
+            for (int digits = 0; digits < 2 && j < size && isOctalDigit(pattern.at(j)); ++digits) ++j;
+        } else {
+            while (j < size && pattern.at(j).isDigit()) ++j;
+        }
+        return j - 1;
+    }
+
+    switch (kind.unicode()) {
+    case 'x':
+        if (next() == '{') return skipTo(pattern, j, '}');
+        for (int digits = 0; digits < 2 && j < size && isHexDigit(pattern.at(j)); ++digits) ++j;
+        return j - 1;
+    case 'o':
+        return next() == '{' ? skipTo(pattern, j, '}') : -1;
+    case 'c':
+        // \cX is one control character
+        return qMin(j, size - 1);
+    case 'p':
+    case 'P':
+    case 'N':
+        // \p{Greek}, \pL, \N{U+41}; a bare \N is any character but a newline
+        if (next() == '{') return skipTo(pattern, j, '}');
+        return kind == 'N' ? i + 1 : qMin(j, size - 1);
+    case 'g':
+    case 'k':
+        // Back references by number or name
+        if (next() == '{') return skipTo(pattern, j, '}');
+        if (next() == '<') return skipTo(pattern, j, '>');
+        if (next() == '\'') return skipTo(pattern, j + 1, '\'');
+        while (j < size && (pattern.at(j).isDigit() || pattern.at(j) == '-' || pattern.at(j) == '+')) ++j;
+        return j - 1;
+    case 'Q': {
+        // Quoted text is literal, but may carry characters we would misread; skip it
+        const qsizetype end = pattern.indexOf(QLatin1String("\\E"), j);
+        return end < 0 ? size - 1 : end + 1;
+    }
+    default:
+        return -1;
+    }
+}
+
+} // namespace
+
+// Shared with the search task, so its snapshot outlives a cancelled search
+struct LogSearch::Search
+{
+    LogStore::Snapshot snapshot;
+    Mode mode = Mode::Substring;
+    QString pattern;
+    QByteArray needle;
+    bool asciiNeedle = false;
+    QRegularExpression regex;
+    std::vector<std::uint32_t> keys;    // empty: every line is checked
+    std::atomic<bool> cancelled{false};
+};
+
+LogSearch::LogSearch(QObject *parent)
+    : QObject(parent)
+{
+    // One search at a time; a cancelled one stops at its next chunk
+    pool.setMaxThreadCount(1);
+}
+
+LogSearch::~LogSearch()
+{
+    cancel();
+    pool.waitForDone();
+}
+
+bool LogSearch::start(const LogStore &store, const QString &pattern, Mode mode, QString *errorString)
+{
+    cancel();
+    if (pattern.isEmpty()) return true;
+
+    auto state = std::make_shared<Search>();
+    state->mode = mode;
+    state->pattern = pattern;
+    state->needle = pattern.toUtf8().toLower();
+    state->asciiNeedle = isAscii(state->needle);
+
+    std::vector<std::string> literals;
+    if (mode == Mode::Regex) {
+        state->regex = QRegularExpression(pattern, QRegularExpression::CaseInsensitiveOption);
+        if (!state->regex.isValid()) {
+            if (errorString) *errorString = state->regex.errorString();
+            return false;
+        }
+        literals = requiredLiterals(pattern);
+    } else {
+        literals.push_back(state->needle.toStdString());
+    }
+    state->keys = TrigramIndex::queryKeys(literals);
+    state->snapshot = store.snapshot();
+
+    search = state;
+    pool.start([this, state]() { run(state, this); });
+    return true;
+}
+
+void LogSearch::cancel()
+{
+    if (search) {
+        search->cancelled.store(true, std::memory_order_relaxed);
+        search.reset();
+    }
+    for (QList<int> &rows : rankedRows) {
+        rows.clear();
+    }
+}
+
+int LogSearch::hitCount() const
+{
+    int count = 0;
+    for (const QList<int> &rows : rankedRows) {
+        count += int(rows.size());
+    }
+    return count;
+}
+
+int LogSearch::hit(int index) const
+{
+    for (const QList<int> &rows : rankedRows) {
+        if (index < rows.size()) return rows.at(index);
+        index -= int(rows.size());
+    }
+    return -1;
+}
+
+int LogSearch::indexOfHit(int row) const
+{
+    int before = 0;
+    for (const QList<int> &rows : rankedRows) {
+        const auto it = std::lower_bound(rows.cbegin(), rows.cend(), row);
+        if (it != rows.cend() && *it == row) return before + int(it - rows.cbegin());
+        before += int(rows.size());
+    }
+    return -1;
+}
+
+void LogSearch::run(const std::shared_ptr<Search> &search, LogSearch *receiver)
+{
+    const Search &state = *search;
+
+    auto matches = [&state](QByteArrayView line) {
+        if (state.mode == Mode::Regex) return state.regex.match(QString::fromUtf8(line)).hasMatch();
+        if (state.asciiNeedle) return containsFolded(line, state.needle);
+        return QString::fromUtf8(line).contains(state.pattern, Qt::CaseInsensitive);
+    };
+
+    LogStore::ChunkView chunk;
+    std::vector<std::uint32_t> blocks;
+    for (qsizetype i = 0; i < state.snapshot.chunkCount(); ++i) {
+        if (state.cancelled.load(std::memory_order_relaxed)) return;
+        if (!state.snapshot.loadIndex(i, &chunk)) continue;
+
+        Batch batch;
+        auto scan = [&](qsizetype first, qsizetype last) {
+            if (!state.snapshot.loadLines(i, first, last, &chunk)) return;
+            for (qsizetype line = first; line < last; ++line) {
+                if (matches(chunk.line(line))) {
+                    batch.rows[rank(chunk.lineClass(line))].append(int(chunk.firstLine + line));
+                }
+            }
+        };
+
+        if (chunk.indexed && !state.keys.empty()) {
+            // A spilled chunk without candidates is never read; otherwise only
+            // runs of adjacent candidate blocks are
+            TrigramIndex::candidateBlocks(chunk.trigrams.constData(), std::size_t(chunk.trigrams.size()), state.keys, &blocks);
+            for (std::size_t b = 0; b < blocks.size();) {
+                std::size_t e = b + 1;
+                while (e < blocks.size() && blocks[e] == blocks[e - 1] + 1) {
+                    ++e;
+                }
+                const qsizetype first = qsizetype(blocks[b]) * TrigramIndex::BlockLines;
+                scan(first, qMin(qsizetype(blocks[e - 1] + 1) * TrigramIndex::BlockLines, chunk.lineCount()));
+                b = e;
+            }
+        } else {
+            // The open chunk has no index yet
+            scan(0, chunk.lineCount());
+        }
+
+        if (std::any_of(std::begin(batch.rows), std::end(batch.rows), [](const QList<int> &rows) { return !rows.isEmpty(); })) {
+            QMetaObject::invokeMethod(receiver, [receiver, search, batch = std::move(batch)]() {
+                receiver->addBatch(search, batch);
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    QMetaObject::invokeMethod(receiver, [receiver, search]() { receiver->searchDone(search); }, Qt::QueuedConnection);
+}
+
+void LogSearch::addBatch(const std::shared_ptr<Search> &source, const Batch &batch)
+{
+    if (source != search) return;
+
+    // Chunks arrive in log order, so appending keeps every rank sorted
+    for (int i = 0; i < RankCount; ++i) {
+        rankedRows[i].append(batch.rows[i]);
+    }
+    emit hitsChanged();
+}
+
+void LogSearch::searchDone(const std::shared_ptr<Search> &source)
+{
+    if (source != search) return;
+
+    search.reset();
+    emit finished();
+}
+
+std::vector<std::string> LogSearch::requiredLiterals(const QString &pattern)
+{
+    std::vector<std::string> literals;
+
+    // Any alternation could make every literal optional, and inline
+    // options like (?x) change what a literal character means
+    if (pattern.contains('|') || pattern.contains(QLatin1String("(?"))) return literals;
+
+    QString run;
+    auto endRun = [&]() {
+        if (!run.isEmpty()) literals.push_back(run.toStdString());
+        run.clear();
+    };
+
+    int depth = 0;
+    for (qsizetype i = 0; i < pattern.size(); ++i) {
+        const QChar c = pattern.at(i);
+
+        if (c == '\\' && i + 1 < pattern.size()) {
+            const QChar next = pattern.at(i + 1);
+            if (!next.isLetterOrNumber()) {
+                // An escaped punctuation character stands for itself
+                if (depth == 0) run += next;
+                ++i;
+                continue;
+            }
+            // Everything else, including the digits or name that follow it, is not literal text
+            endRun();
+            i = skipEscape(pattern, i);
+            if (i < 0) break;
+        } else if (c == '[') {
+            endRun();
+            // Skip the class, including a leading ']' and escaped characters
+            qsizetype j = i + 1;
+            if (j < pattern.size() && pattern.at(j) == '^') ++j;
+            if (j < pattern.size() && pattern.at(j) == ']') ++j;
+            while (j < pattern.size() && pattern.at(j) != ']') {
+                if (pattern.at(j) == '\\') {
+                    ++j;
+                } else if (pattern.at(j) == '[' && j + 1 < pattern.size() && pattern.at(j + 1) == ':') {
+                    // [:alpha:] and the like end in their own ']'
+                    const qsizetype close = pattern.indexOf(QLatin1String(":]"), j + 2);
+                    if (close >= 0) j = close + 1;
+                }
+                ++j;
+            }
+            i = j;
+        } else if (c == '(') {
+            endRun();
+            ++depth;
+        } else if (c == ')') {
+            endRun();
+            depth = qMax(0, depth - 1);
+        } else if (c == '*' || c == '?' || c == '{') {
+            // The preceding character may be absent
+            if (!run.isEmpty()) run.chop(1);
+            endRun();
+            if (c == '{') {
+                while (i < pattern.size() && pattern.at(i) != '}') ++i;
+            }
+        } else if (c == '+' || c == '.' || c == '^' || c == '$') {
+            endRun();
+        } else if (depth == 0) {
+            run += c;
+        }
+    }
+    endRun();
+    return literals;
+}
@@ -0,0 +1,82 @@
+#ifndef LOGSEARCH_H
+#define LOGSEARCH_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "logline.h"
+
+class LogStore;
+
+// Case-insensitive substring and regex search over a LogStore.
+//
+// A search runs on a private thread pool over a snapshot of the store, so
+// the GUI thread never scans and output keeps arriving meanwhile. Chunks
+// are searched in log order; in each sealed chunk only the blocks whose
+// trigram index holds all trigrams of the query (or of the literal runs a
+// regex cannot match without) are checked, and of a chunk on disk only
+// those blocks are read back. Hits are handed over chunk by
+// chunk through hitsChanged() and ranked errors first, then warnings, then
+// everything else, each group in log order.
+//
+// Lives on the GUI thread; signals are emitted from its event loop.
+class LogSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Mode
+    {
+        Substring,
+        Regex
+    };
+
+    explicit LogSearch(QObject *parent = nullptr);
+    ~LogSearch();
+
+    // Searches the lines the store holds now, dropping any earlier search.
+    // Returns false and sets errorString if the pattern is not a valid regex.
+    bool start(const LogStore &store, const QString &pattern, Mode mode, QString *errorString = nullptr);
+    void cancel();
+    bool isRunning() const { return bool(search); }
+
+    // Ranked hits found so far
+    int hitCount() const;
+    int hit(int index) const;
+
+    // Position of a row among the ranked hits, or -1
+    int indexOfHit(int row) const;
+
+    // Literal runs every match of the regex must contain; empty if unsure
+    static std::vector<std::string> requiredLiterals(const QString &pattern);
+
+signals:
+    void hitsChanged();
+    void finished();
+
+private:
+    struct Search;
+
+    static constexpr int RankCount = 3;
+
+    struct Batch
+    {
+        QList<int> rows[RankCount];
+    };
+
+    static void run(const std::shared_ptr<Search> &search, LogSearch *receiver);
+    void addBatch(const std::shared_ptr<Search> &source, const Batch &batch);
+    void searchDone(const std::shared_ptr<Search> &source);
+
+    QThreadPool pool;
+    std::shared_ptr<Search> search;
+    QList<int> rankedRows[RankCount];   // each in log order
+};
+
+#endif // LOGSEARCH_H
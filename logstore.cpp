@@ -0,0 +1,360 @@
+#include "logstore.h"
+
+#include <QDir>
+#include <QFile>
+#include <QtDebug>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+LogStore::LogStore(qsizetype chunkSize, int hotChunks)
+    : chunkSize(chunkSize)
+    , maxHotChunks(qMax(1, hotChunks))
+    , spillFile(QDir::tempPath() + "/qt6-installer-log-XXXXXX.spill")
+{
+}
+
+LogStore::~LogStore()
+{
+    clear();
+}
+
+void LogStore::append(const LogLine &line)
+{
+    const StyleSpans &spans = line.spans;
+    const qsizetype spanBytes = spans.isEmpty() ? 0 : spans.size() * qsizetype(sizeof(StyleSpan)) + qsizetype(sizeof(quint32));
+    const qsizetype recordSize = HeaderSize + line.text.size() + spanBytes;
+
+    if (chunks.isEmpty() || chunks.last().size + recordSize > chunks.last().data.capacity()
+        || chunks.last().offsets.size() >= qsizetype(TrigramIndex::MaxLines)) {
+        if (!chunks.isEmpty()) {
+            sealCurrentChunk();
+        }
+
+        Chunk chunk;
+        chunk.firstLine = lines;
+        chunk.data.reserve(qMax(chunkSize, recordSize));
+        chunks.append(std::move(chunk));
+    }
+
+    Chunk &chunk = chunks.last();
+    openIndex.addLine(quint32(chunk.offsets.size()), line.text.constData(), std::size_t(line.text.size()));
+    chunk.offsets.append(quint32(chunk.size));
+    chunk.tags.append(quint8(line.lineClass)
+                      | quint8(quint8(line.channel) << ChannelShift)
+                      | (spans.isEmpty() ? 0 : HasSpansFlag));
+    ++lines;
+
+    const RecordHeader header{line.timestampUs, line.sequence};
+    chunk.data.append(reinterpret_cast<const char *>(&header), HeaderSize);
+    chunk.data.append(line.text);
+    if (!spans.isEmpty()) {
+        const quint32 count = quint32(spans.size());
+        chunk.data.append(reinterpret_cast<const char *>(spans.constData()), spans.size() * qsizetype(sizeof(StyleSpan)));
+        chunk.data.append(reinterpret_cast<const char *>(&count), sizeof(count));
+    }
+    chunk.size += recordSize;
+    totalBytes += recordSize;
+}
+
+void LogStore::clear()
+{
+    for (Chunk &chunk : chunks) {
+        if (chunk.mapped) {
+            spillFile.unmap(chunk.mapped);
+        }
+    }
+    chunks.clear();
+    openIndex.clear();
+    lines = 0;
+    totalBytes = 0;
+    residentSealed = 0;
+    mappedCount = 0;
+
+    if (spillFile.isOpen()) {
+        spillFile.resize(0);
+        spillFile.seek(0);
+    }
+}
+
+QByteArrayView LogStore::line(qsizetype index) const
+{
+    return textOf(record(index), tag(index));
+}
+
+QByteArrayView LogStore::textOf(QByteArrayView record, quint8 tag)
+{
+    if (record.size() < HeaderSize) return QByteArrayView();
+    QByteArrayView bytes = record.sliced(HeaderSize);
+
+    if ((tag & HasSpansFlag) && bytes.size() >= qsizetype(sizeof(quint32))) {
+        quint32 count = 0;
+        std::memcpy(&count, bytes.data() + bytes.size() - sizeof(count), sizeof(count));
+        const qint64 spanBytes = qint64(sizeof(count)) + qint64(count) * qint64(sizeof(StyleSpan));
+        if (spanBytes > bytes.size()) return QByteArrayView();
+        bytes.chop(qsizetype(spanBytes));
+    }
+    return bytes;
+}
+
+QByteArrayView LogStore::ChunkView::line(qsizetype index) const
+{
+    return textOf(recordIn(data.constData(), data.size(), offsets, index, dataStart), tags.at(index));
+}
+
+qint64 LogStore::timestampUs(qsizetype index) const
+{
+    return header(index).timestampUs;
+}
+
+quint64 LogStore::sequence(qsizetype index) const
+{
+    return header(index).sequence;
+}
+
+LogStore::RecordHeader LogStore::header(qsizetype index) const
+{
+    RecordHeader result{0, 0};
+    const QByteArrayView bytes = record(index);
+    if (bytes.size() >= HeaderSize) {
+        std::memcpy(&result, bytes.data(), HeaderSize);
+    }
+    return result;
+}
+
+StyleSpans LogStore::spans(qsizetype index) const
+{
+    StyleSpans result;
+    if (!hasSpans(index)) return result;
+
+    const QByteArrayView bytes = record(index);
+    if (bytes.size() < HeaderSize + qsizetype(sizeof(quint32))) return result;
+
+    quint32 count = 0;
+    std::memcpy(&count, bytes.data() + bytes.size() - sizeof(count), sizeof(count));
+    result.resize(count);
+    std::memcpy(result.data(), bytes.data() + bytes.size() - sizeof(count) - count * sizeof(StyleSpan), count * sizeof(StyleSpan));
+    return result;
+}
+
+QByteArrayView LogStore::record(qsizetype index) const
+{
+    const qsizetype chunkIndex = chunkForLine(index);
+    const Chunk &chunk = chunks.at(chunkIndex);
+
+    const char *bytes = chunkBytes(chunkIndex);
+    if (!bytes) return QByteArrayView();
+    return recordIn(bytes, chunk.size, chunk.offsets, index - chunk.firstLine);
+}
+
+QByteArrayView LogStore::recordIn(const char *bytes, qsizetype size, const QList<quint32> &offsets, qsizetype index,
+                                  qsizetype base)
+{
+    // bytes holds the chunk from offset base on, possibly not up to its end
+    const qsizetype begin = offsets.at(index) - base;
+    const qsizetype end = index + 1 < offsets.size() ? qsizetype(offsets.at(index + 1)) - base : size;
+    if (begin < 0 || end > size) return QByteArrayView();
+    return QByteArrayView(bytes + begin, end - begin);
+}
+
+quint8 LogStore::tag(qsizetype index) const
+{
+    const Chunk &chunk = chunks.at(chunkForLine(index));
+    return chunk.tags.at(index - chunk.firstLine);
+}
+
+void LogStore::setHotChunks(int chunks)
+{
+    maxHotChunks = qMax(1, chunks);
+    spillColdChunks();
+}
+
+qint64 LogStore::residentBytes() const
+{
+    qint64 bytes = 0;
+    for (const Chunk &chunk : chunks) {
+        if (chunk.fileOffset < 0) {
+            bytes += chunk.data.capacity() + chunk.trigrams.size() * qsizetype(sizeof(quint32));
+        } else if (chunk.mapped) {
+            bytes += chunk.size;
+        }
+    }
+    return bytes;
+}
+
+qsizetype LogStore::chunkForLine(qsizetype index) const
+{
+    auto it = std::upper_bound(chunks.cbegin(), chunks.cend(), index,
+        [](qsizetype line, const Chunk &chunk) { return line < chunk.firstLine; });
+    return (it - chunks.cbegin()) - 1;
+}
+
+const char *LogStore::chunkBytes(qsizetype chunkIndex) const
+{
+    Chunk &chunk = chunks[chunkIndex];
+    chunk.lastUse = ++useClock;
+
+    if (chunk.fileOffset < 0) {
+        return chunk.data.constData();
+    }
+
+    if (!chunk.mapped) {
+        if (mappedCount >= maxHotChunks) {
+            unmapLeastRecent();
+        }
+        chunk.mapped = spillFile.map(chunk.fileOffset, chunk.size);
+        if (!chunk.mapped) {
+            qWarning() << "LogStore: failed to map spilled chunk:" << spillFile.errorString();
+            return nullptr;
+        }
+        ++mappedCount;
+    }
+    return reinterpret_cast<const char *>(chunk.mapped);
+}
+
+void LogStore::sealCurrentChunk()
+{
+    const std::vector<std::uint32_t> entries = openIndex.take();
+    Chunk &chunk = chunks.last();
+    chunk.trigrams = QList<quint32>(entries.cbegin(), entries.cend());
+    chunk.trigramCount = chunk.trigrams.size();
+
+    ++residentSealed;
+    spillColdChunks();
+}
+
+void LogStore::spillColdChunks()
+{
+    if (residentSealed <= maxHotChunks) return;
+    if (!openSpillFile()) return;
+
+    // Sealed chunks are spilled oldest first; the open chunk is never spilled
+    const qsizetype sealedCount = chunks.size() - (chunks.isEmpty() ? 0 : 1);
+    for (qsizetype i = 0; i < sealedCount && residentSealed > maxHotChunks; ++i) {
+        Chunk &chunk = chunks[i];
+        if (chunk.fileOffset >= 0) continue;
+
+        // The chunk's index goes right after its bytes
+        const qint64 offset = spillFile.size();
+        const qint64 indexBytes = chunk.trigramCount * qint64(sizeof(quint32));
+        spillFile.seek(offset);
+        if (spillFile.write(chunk.data.constData(), chunk.size) != chunk.size
+            || spillFile.write(reinterpret_cast<const char *>(chunk.trigrams.constData()), indexBytes) != indexBytes) {
+            qWarning() << "LogStore: failed to spill chunk:" << spillFile.errorString();
+            spillFile.resize(offset);
+            return;
+        }
+
+        chunk.fileOffset = offset;
+        chunk.data = QByteArray();
+        chunk.trigrams = QList<quint32>();
+        --residentSealed;
+    }
+
+    // Mappings read the file directly, so buffered writes must reach it first
+    spillFile.flush();
+}
+
+bool LogStore::openSpillFile()
+{
+    if (spillFile.isOpen()) return true;
+    if (spillDisabled) return false;
+    if (!spillFile.open()) {
+        qWarning() << "LogStore: cannot create spill file, keeping log in memory:" << spillFile.errorString();
+        spillDisabled = true;
+        return false;
+    }
+    return true;
+}
+
+void LogStore::unmapLeastRecent() const
+{
+    Chunk *oldest = nullptr;
+    for (Chunk &chunk : chunks) {
+        if (chunk.mapped && (!oldest || chunk.lastUse < oldest->lastUse)) {
+            oldest = &chunk;
+        }
+    }
+    if (oldest) {
+        spillFile.unmap(oldest->mapped);
+        oldest->mapped = nullptr;
+        --mappedCount;
+    }
+}
+
+LogStore::Snapshot LogStore::snapshot() const
+{
+    Snapshot result;
+    result.lines = lines;
+    result.spillPath = spillFile.fileName();
+    result.entries.reserve(chunks.size());
+
+    for (qsizetype i = 0; i < chunks.size(); ++i) {
+        const Chunk &chunk = chunks.at(i);
+        Snapshot::Entry entry;
+        entry.view.firstLine = chunk.firstLine;
+        entry.view.offsets = chunk.offsets;
+        entry.view.tags = chunk.tags;
+        entry.view.indexed = i + 1 < chunks.size();
+        entry.fileOffset = chunk.fileOffset;
+        entry.size = chunk.size;
+        entry.trigramCount = chunk.trigramCount;
+
+        if (chunk.fileOffset < 0) {
+            // The open chunk is still appended to, so it is copied rather than shared
+            entry.view.data = entry.view.indexed ? chunk.data : QByteArray(chunk.data.constData(), chunk.size);
+            entry.view.trigrams = chunk.trigrams;
+        }
+        result.entries.append(std::move(entry));
+    }
+    return result;
+}
+
+bool LogStore::Snapshot::loadIndex(qsizetype index, ChunkView *view) const
+{
+    const Entry &entry = entries.at(index);
+    *view = entry.view;
+    if (entry.fileOffset < 0 || !view->indexed) return true;
+
+    // Read rather than mapped: clear() may truncate the file under us.
+    // The index follows the chunk's bytes.
+    QFile file(spillPath);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(entry.fileOffset + entry.size)) return false;
+
+    const QByteArray entryBytes = file.read(entry.trigramCount * qint64(sizeof(quint32)));
+    if (entryBytes.size() != entry.trigramCount * qsizetype(sizeof(quint32))) return false;
+    view->trigrams.resize(entry.trigramCount);
+    std::memcpy(view->trigrams.data(), entryBytes.constData(), entryBytes.size());
+    return true;
+}
+
+bool LogStore::Snapshot::loadLines(qsizetype index, qsizetype first, qsizetype last, ChunkView *view) const
+{
+    const Entry &entry = entries.at(index);
+    if (entry.fileOffset < 0) {
+        // Resident bytes are shared whole, which costs nothing
+        view->data = entry.view.data;
+        view->dataStart = 0;
+        return true;
+    }
+
+    view->data.clear();
+    view->dataStart = 0;
+    if (first >= last) return true;
+
+    const QList<quint32> &offsets = entry.view.offsets;
+    const qsizetype begin = offsets.at(first);
+    const qsizetype end = last < offsets.size() ? qsizetype(offsets.at(last)) : entry.size;
+
+    QFile file(spillPath);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(entry.fileOffset + begin)) return false;
+    view->data = file.read(end - begin);
+    view->dataStart = begin;
+    return view->data.size() == end - begin;
+}
+
+bool LogStore::Snapshot::loadChunk(qsizetype index, ChunkView *view) const
+{
+    return loadIndex(index, view) && loadLines(index, 0, view->lineCount(), view);
+}
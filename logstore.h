@@ -0,0 +1,172 @@
+#ifndef LOGSTORE_H
+#define LOGSTORE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+#include <QTemporaryFile>
+
+#include "logline.h"
+#include "trigramindex.h"
+
+// Append-only store for the installation log.
+//
+// Line bytes are packed into large arena chunks; every chunk keeps a 32-bit
+// offset and a tag byte (class, channel and flags) per line. Each record
+// starts with the line's timestamp and sequence number; a line with style
+// spans stores them after its text, followed by the span count. A chunk is
+// trigram-indexed as it fills (see TrigramIndex), and the index is sealed
+// with it. Once more than hotChunks sealed chunks are resident, the oldest
+// ones are written to a temporary spill file together with their index and
+// dropped from memory. A spilled chunk is memory-mapped back when one of its
+// lines is requested and unmapped again when it falls out of a small LRU
+// window. snapshot() hands the chunks to a search on another thread.
+class LogStore
+{
+public:
+    static constexpr qsizetype DefaultChunkSize = 4 * 1024 * 1024;
+    static constexpr int DefaultHotChunks = 16;
+
+    explicit LogStore(qsizetype chunkSize = DefaultChunkSize, int hotChunks = DefaultHotChunks);
+    ~LogStore();
+
+    LogStore(const LogStore &) = delete;
+    LogStore &operator=(const LogStore &) = delete;
+
+    void append(const LogLine &line);
+    void clear();
+
+    qsizetype lineCount() const { return lines; }
+
+    // The view stays valid until the next call to line() or append()
+    QByteArrayView line(qsizetype index) const;
+    LineClass lineClass(qsizetype index) const { return tagClass(tag(index)); }
+    LogChannel channel(qsizetype index) const { return LogChannel((tag(index) & ChannelMask) >> ChannelShift); }
+    bool hasSpans(qsizetype index) const { return tag(index) & HasSpansFlag; }
+    StyleSpans spans(qsizetype index) const;
+
+    qint64 timestampUs(qsizetype index) const;
+    quint64 sequence(qsizetype index) const;
+
+    void setHotChunks(int chunks);
+    int hotChunks() const { return maxHotChunks; }
+
+    qint64 storedBytes() const { return totalBytes; }
+    qint64 residentBytes() const;
+
+    // One chunk as a search on another thread reads it
+    struct ChunkView
+    {
+        qsizetype firstLine = 0;
+        QByteArray data;            // bytes of the loaded lines
+        qsizetype dataStart = 0;    // chunk offset of data's first byte
+        QList<quint32> offsets;
+        QList<quint8> tags;
+        QList<quint32> trigrams;    // sorted TrigramIndex entries
+        bool indexed = false;       // false for the chunk still being filled
+
+        qsizetype lineCount() const { return offsets.size(); }
+        // Empty for a line outside the loaded range
+        QByteArrayView line(qsizetype index) const;
+        LineClass lineClass(qsizetype index) const { return tagClass(tags.at(index)); }
+    };
+
+    // The chunks as they are now, safe to read on another thread while the
+    // store goes on appending. Resident chunks are shared; spilled ones are
+    // read back from the spill file. Not valid across clear().
+    class Snapshot
+    {
+    public:
+        qsizetype chunkCount() const { return entries.size(); }
+        qsizetype lineCount() const { return lines; }
+
+        // Everything but the line bytes. Of a spilled chunk only the trigram
+        // entries are read, so a search can skip it without touching its data.
+        bool loadIndex(qsizetype index, ChunkView *view) const;
+
+        // Replaces view->data with the bytes of lines [first, last)
+        bool loadLines(qsizetype index, qsizetype first, qsizetype last, ChunkView *view) const;
+
+        // Both, for all lines. All three return false if a spilled chunk can
+        // no longer be read back.
+        bool loadChunk(qsizetype index, ChunkView *view) const;
+
+    private:
+        friend class LogStore;
+
+        struct Entry
+        {
+            ChunkView view;
+            qint64 fileOffset = -1;
+            qsizetype size = 0;
+            qsizetype trigramCount = 0;
+        };
+
+        QList<Entry> entries;
+        QString spillPath;
+        qsizetype lines = 0;
+    };
+
+    Snapshot snapshot() const;
+
+private:
+    static constexpr quint8 ClassMask = 0x0f;
+    static constexpr quint8 ChannelMask = 0x30;
+    static constexpr int ChannelShift = 4;
+    static constexpr quint8 HasSpansFlag = 0x80;
+
+    struct RecordHeader
+    {
+        qint64 timestampUs;
+        quint64 sequence;
+    };
+
+    static constexpr qsizetype HeaderSize = qsizetype(sizeof(RecordHeader));
+
+    struct Chunk
+    {
+        qsizetype firstLine = 0;
+        qsizetype size = 0;
+        QByteArray data;            // resident bytes, empty once spilled
+        QList<quint32> offsets;     // offset of each line inside the chunk
+        QList<quint8> tags;
+        QList<quint32> trigrams;    // index of a sealed chunk, empty once spilled
+        qsizetype trigramCount = 0;
+        qint64 fileOffset = -1;     // position in the spill file, -1 while resident
+        uchar *mapped = nullptr;    // mapping of a spilled chunk, if any
+        quint64 lastUse = 0;
+    };
+
+    static LineClass tagClass(quint8 tag) { return LineClass(tag & ClassMask); }
+    static QByteArrayView recordIn(const char *bytes, qsizetype size, const QList<quint32> &offsets, qsizetype index,
+                                   qsizetype base = 0);
+    static QByteArrayView textOf(QByteArrayView record, quint8 tag);
+
+    qsizetype chunkForLine(qsizetype index) const;
+    quint8 tag(qsizetype index) const;
+    QByteArrayView record(qsizetype index) const;
+    RecordHeader header(qsizetype index) const;
+    const char *chunkBytes(qsizetype chunkIndex) const;
+    void sealCurrentChunk();
+    void spillColdChunks();
+    bool openSpillFile();
+    void unmapLeastRecent() const;
+
+    qsizetype chunkSize;
+    int maxHotChunks;
+
+    mutable QList<Chunk> chunks;
+    TrigramIndex openIndex;         // of the last chunk, until it is sealed
+    qsizetype lines = 0;
+
+    qint64 totalBytes = 0;
+    int residentSealed = 0;
+
+    mutable QTemporaryFile spillFile;
+    bool spillDisabled = false;
+    mutable int mappedCount = 0;
+    mutable quint64 useClock = 0;
+};
+
+#endif // LOGSTORE_H
@@ -0,0 +1,212 @@
+#include "logwriter.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTimer>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <io.h>
+#endif
+
+#include "sessionclock.h"
+
+LogWriter::LogWriter(QObject *parent)
+    : QObject(parent)
+    , flushTimer(new QTimer(this))
+{
+    flushTimer->setInterval(FlushIntervalMs);
+    connect(flushTimer, &QTimer::timeout, this, &LogWriter::flush);
+
+    const int rotateMb = qEnvironmentVariableIntValue("QT6_INSTALLER_LOG_ROTATE_MB");
+    if (rotateMb > 0) {
+        setRotateBytes(rotateMb * 1024LL * 1024);
+    }
+}
+
+QString LogWriter::defaultDirectory()
+{
+    const QString overrideDirectory = qEnvironmentVariable("QT6_INSTALLER_LOG_DIR");
+    if (!overrideDirectory.isEmpty()) return overrideDirectory;
+
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/logs";
+}
+
+QString LogWriter::sessionPath(const QString &directory)
+{
+    return directory + "/qt6-install-" + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".log";
+}
+
+bool LogWriter::parseLine(QByteArrayView *text, qint64 *timestampUs, LogChannel *channel)
+{
+    const qsizetype prefixSize = SessionClock::ElapsedTextSize + TagSize;
+    if (text->size() < prefixSize) return false;
+    if (!SessionClock::parseElapsed(text->data(), timestampUs)) return false;
+
+    const QByteArrayView tag = text->sliced(SessionClock::ElapsedTextSize, TagSize);
+    const LogChannel channels[] = {LogChannel::Stdout, LogChannel::Stderr, LogChannel::Installer};
+    for (const LogChannel candidate : channels) {
+        if (tag == QByteArrayView(channelTag(candidate))) {
+            *channel = candidate;
+            *text = text->sliced(prefixSize);
+            return true;
+        }
+    }
+    return false;
+}
+
+void LogWriter::open(const QString &path)
+{
+    close();
+
+    basePath = path;
+    segment = 0;
+    lastMilestone = -1;
+    broken = false;
+
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) {
+        fail(QString("cannot create %1").arg(QFileInfo(path).absolutePath()));
+        return;
+    }
+    buffer.reserve(BufferSize + BufferSize / 4);
+    if (!openSegment()) return;
+    flushTimer->start();
+}
+
+void LogWriter::append(const LogLineBatch &lines)
+{
+    if (!file.isOpen()) return;
+
+    bool phaseBoundary = false;
+    for (const LogLine &line : lines) {
+        char stamp[SessionClock::ElapsedTextSize];
+        SessionClock::formatElapsed(line.timestampUs, stamp);
+        buffer.append(stamp, SessionClock::ElapsedTextSize);
+        buffer.append(channelTag(line.channel));
+        buffer.append(line.text);
+        buffer.append('\n');
+
+        // Same rule as the progress bar: only a higher milestone is a new phase
+        if (line.progress > lastMilestone) {
+            lastMilestone = line.progress;
+            phaseBoundary = true;
+        }
+        if (buffer.size() >= BufferSize) {
+            flush();
+        }
+    }
+
+    if (phaseBoundary) {
+        flush();
+        sync();
+    }
+}
+
+void LogWriter::close()
+{
+    if (!file.isOpen()) return;
+
+    flush();
+    sync();
+    file.close();
+    flushTimer->stop();
+}
+
+void LogWriter::flush()
+{
+    if (buffer.isEmpty() || !file.isOpen()) return;
+
+    if (file.write(buffer) != buffer.size()) {
+        fail(file.errorString());
+        return;
+    }
+    segmentBytes += buffer.size();
+    buffer.truncate(0);
+
+    if (segmentBytes >= rotateBytes) {
+        rotate();
+    }
+}
+
+bool LogWriter::openSegment()
+{
+    // Unbuffered: our own buffer already makes the writes large
+    file.setFileName(segmentPath(segment));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        fail(file.errorString());
+        return false;
+    }
+    segmentBytes = 0;
+
+    // Every segment starts with the header, so each one loads on its own
+    buffer += SessionHeader;
+    if (segment == 0) {
+        buffer += ", started ";
+    } else {
+        buffer += ", part " + QByteArray::number(segment) + ", continued ";
+    }
+    buffer += QDateTime::currentDateTime().toString(Qt::ISODate).toUtf8();
+    buffer += '\n';
+    return true;
+}
+
+void LogWriter::rotate()
+{
+    sync();
+    file.close();
+
+    ++segment;
+    if (segment >= MaxSegments) {
+        QFile::remove(segmentPath(segment - MaxSegments));
+    }
+    openSegment();
+}
+
+void LogWriter::sync()
+{
+    if (!file.isOpen()) return;
+
+#if defined(Q_OS_MACOS)
+    // Plain fsync() on macOS does not flush the drive's own cache
+    if (::fcntl(file.handle(), F_FULLFSYNC) == -1) {
+        ::fsync(file.handle());
+    }
+#elif defined(Q_OS_UNIX)
+    ::fsync(file.handle());
+#elif defined(Q_OS_WIN)
+    ::_commit(file.handle());
+#endif
+}
+
+void LogWriter::fail(const QString &errorString)
+{
+    if (broken) return;
+    broken = true;
+
+    file.close();
+    buffer.clear();
+    flushTimer->stop();
+    emit failed(QString("%1: %2").arg(basePath, errorString));
+}
+
+const char *LogWriter::channelTag(LogChannel channel)
+{
+    switch (channel) {
+    case LogChannel::Stdout:    return " out ";
+    case LogChannel::Stderr:    return " err ";
+    case LogChannel::Installer: return " gui ";
+    }
+    return " ??? ";
+}
+
+QString LogWriter::segmentPath(int index) const
+{
+    if (index == 0) return basePath;
+
+    const QFileInfo info(basePath);
+    return info.path() + '/' + info.completeBaseName() + QString(".%1.").arg(index) + info.suffix();
+}
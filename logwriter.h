@@ -0,0 +1,85 @@
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QObject>
+#include <QString>
+
+#include "logline.h"
+
+class QTimer;
+
+// Saves the session log to disk on its own thread.
+//
+// Each line is written as "hh:mm:ss.mmm chan text", where chan is out, err
+// or gui; every file, rotated ones included, starts with a SessionHeader
+// line. parseLine() reads that format back.
+//
+// Lines are formatted into a large buffer and written in big chunks; a
+// timer pushes out whatever is left once a second, so a crash of the GUI
+// loses at most that much. The file is fsync'ed at every phase boundary
+// and when the session ends, so the log up to the last milestone survives
+// even a power loss. A file that grows past the rotation size is closed and
+// the session continues in "<name>.1.log", "<name>.2.log" and so on, keeping
+// at most MaxSegments files; past that the oldest segment is deleted.
+// close() must run on the writer's thread before it is destroyed.
+class LogWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 DefaultRotateBytes = 256LL * 1024 * 1024;
+    static constexpr int MaxSegments = 8;
+
+    explicit LogWriter(QObject *parent = nullptr);
+
+    static constexpr char SessionHeader[] = "# qt6-installer-gui session log";
+
+    // $QT6_INSTALLER_LOG_DIR, or a logs folder in the app's data directory
+    static QString defaultDirectory();
+
+    // A new "qt6-install-<date>-<time>.log" path in the given directory
+    static QString sessionPath(const QString &directory);
+
+    // Strips the time and channel prefix off a line of a session log
+    static bool parseLine(QByteArrayView *text, qint64 *timestampUs, LogChannel *channel);
+
+public slots:
+    void open(const QString &path);
+    void append(const LogLineBatch &lines);
+    void close();
+    void setRotateBytes(qint64 bytes) { rotateBytes = qMax<qint64>(BufferSize, bytes); }
+
+signals:
+    void failed(const QString &errorString);
+
+private slots:
+    void flush();
+
+private:
+    static constexpr qsizetype BufferSize = 1024 * 1024;
+    static constexpr int FlushIntervalMs = 1000;
+    static constexpr int TagSize = 5;   // " out "
+
+    static const char *channelTag(LogChannel channel);
+
+    bool openSegment();
+    void rotate();
+    void sync();
+    void fail(const QString &errorString);
+    QString segmentPath(int index) const;
+
+    QFile file;
+    QTimer *flushTimer;
+    QByteArray buffer;
+    QString basePath;
+    qint64 rotateBytes = DefaultRotateBytes;
+    qint64 segmentBytes = 0;
+    int segment = 0;
+    int lastMilestone = -1;
+    bool broken = false;
+};
+
+#endif // LOGWRITER_H
@@ -4,7 +4,7 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
-#include <QTextEdit>
+#include <QListView>
 #include <QLabel>
 #include <QProgressBar>
 #include <QCheckBox>
@@ -14,13 +14,44 @@
 #include <QScrollBar>
 #include <QGroupBox>
 #include <QFont>
+#include <QTimer>
+#include <QThread>
+#include <QLineEdit>
+#include <QShortcut>
+#include <QElapsedTimer>
+#include <QDockWidget>
+#include <QComboBox>
+#include <QToolButton>
+#include <QTreeView>
+#include <QHeaderView>
+#include <QSortFilterProxyModel>
+#include <QFileInfo>
+
+#include <algorithm>
+
+#include "daemonclient.h"
+#include "diagnosticmodel.h"
+#include "etaestimator.h"
+#include "headlessrunner.h"
+#include "installcheckpoint.h"
+#include "installdaemon.h"
+#include "installworker.h"
+#include "logdelegate.h"
+#include "logfileloader.h"
+#include "logfiltermodel.h"
+#include "logwriter.h"
+#include "logmodel.h"
+#include "logsearch.h"
+#include "phasehistory.h"
+#include "resourcemonitor.h"
+#include "resourcesampler.h"
 
 class Qt6InstallerGUI : public QMainWindow
 {
     Q_OBJECT
 
 public:
-    Qt6InstallerGUI(QWidget *parent = nullptr) : QMainWindow(parent)
+    Qt6InstallerGUI(QWidget *parent = nullptr) : QMainWindow(parent), lineQueue(LineQueueCapacity)
     {
         setupUI();
         setupProcess();
@@ -28,10 +59,12 @@ public:
 
     ~Qt6InstallerGUI()
     {
-        if (process && process->state() != QProcess::NotRunning) {
-            process->kill();
-            process->waitForFinished();
-        }
+        // Only the window closes; a running build carries on in the daemon
+        QMetaObject::invokeMethod(daemon, &DaemonClient::shutdown, Qt::BlockingQueuedConnection);
+        workerThread->quit();
+        workerThread->wait();
+        delete resourceSampler;
+        delete daemon;
     }
 
 private slots:
@@ -48,105 +81,200 @@ private slots:
             scriptPath = fileName;
             scriptPathLabel->setText(QString("<b>Script:</b> %1").arg(scriptPath));
             startButton->setEnabled(true);
+            updateResumeButton();
         }
     }
 
     void startInstallation()
     {
-        if (scriptPath.isEmpty()) {
-            QMessageBox::warning(this, "No Script", "Please select install.sh first!");
-            return;
+        runScript(QString());
+    }
+
+    void resumeInstallation()
+    {
+        // The script checks the checkpoint itself and runs everything if it no longer fits
+        InstallCheckpoint checkpoint;
+        checkpoint.load(InstallCheckpoint::defaultPath());
+        if (!checkpoint.failedPhase().isEmpty()) {
+            runScript(checkpoint.failedPhase());
         }
+    }
+
+    void stopInstallation()
+    {
+        if (running && !stopRequested) {
+            // The daemon reports back through processFinished()
+            stopRequested = true;
+            QMetaObject::invokeMethod(daemon, &DaemonClient::stop);
+            stopButton->setEnabled(false);
+            pauseButton->setEnabled(false);
+        }
+    }
+
+    void addResourceSample(const ResourceSample &sample)
+    {
+        if (!resourceMonitor) return;
+
+        const QList<LogModel::Phase> &phases = logModel->phases();
+        resourceMonitor->addSample(sample, phases.isEmpty() ? QString("Startup") : phases.last().title);
+    }
+
+    void togglePause()
+    {
+        // The daemon confirms through pausedChanged() once the signal is sent
+        const bool pause = !paused;
+        QMetaObject::invokeMethod(daemon, [this, pause]() { daemon->setPaused(pause); });
+    }
+
+    void processPausedChanged(bool nowPaused)
+    {
+        paused = nowPaused;
+        const qint64 nowUs = sessionClock.elapsedUs();
+        if (paused) {
+            eta.pause(nowUs);
+            etaTimer->stop();
+            pauseButton->setText("Resume");
+            statusLabel->setText(progressText + " - paused");
+        } else {
+            eta.resume(nowUs);
+            if (running) etaTimer->start();
+            pauseButton->setText("Pause");
+            updateEta();
+        }
+    }
+
+    void processFailedToStart(const QString &errorString)
+    {
+        while (drainLines()) {}
+        flushOutput();
+        running = false;
+        resetUI();
+        statusLabel->setText(QString("Failed to start: %1").arg(errorString));
+    }
+
+    void daemonAttached(const DaemonSession &session)
+    {
+        // A finished run is only replayed for reading; a running one is followed
+        if (!session.running) return;
+
+        running = true;
+        stopRequested = false;
+        paused = session.paused;
+        sessionClock.follow(session.elapsedUs);
+        phaseHistory.load(PhaseHistory::defaultPath());
+        eta.start({QThread::idealThreadCount(), session.jobs, session.qml});
+        if (paused) eta.pause(session.elapsedUs);
 
-        // Disable controls
         startButton->setEnabled(false);
+        resumeButton->setEnabled(false);
         stopButton->setEnabled(true);
+        pauseButton->setEnabled(InstallWorker::canPause());
+        pauseButton->setText(paused ? "Resume" : "Pause");
         browseButton->setEnabled(false);
+        openLogButton->setEnabled(false);
         qmlCheckbox->setEnabled(false);
+        qmlCheckbox->setChecked(session.qml);
+        progressText = "Attached to a running installation";
+        statusLabel->setText(progressText);
+        if (!paused) etaTimer->start();
+    }
 
-        // Clear output
-        outputText->clear();
-        appendOutput("=== Starting Qt6 Installation ===\n", Qt::blue);
-        appendOutput(QString("Script: %1\n").arg(scriptPath), Qt::darkGray);
-        appendOutput(QString("QML Support: %1\n\n").arg(qmlCheckbox->isChecked() ? "Yes" : "No"), Qt::darkGray);
+    void daemonDetached(const QString &reason)
+    {
+        if (!running) return;
 
-        // Prepare process
-        QStringList arguments;
-        arguments << scriptPath;
+        running = false;
+        resetUI();
+        statusLabel->setText(QString("Detached: %1").arg(reason));
+    }
 
-        // Set environment variable for QML choice
-        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-        env.insert("BUILD_QML", qmlCheckbox->isChecked() ? "y" : "n");
-        process->setProcessEnvironment(env);
+    void openLogFile()
+    {
+        const QString fileName = QFileDialog::getOpenFileName(
+            this,
+            tr("Open Log"),
+            LogWriter::defaultDirectory(),
+            tr("Log Files (*.log *.txt);;All Files (*)")
+        );
+        if (fileName.isEmpty()) return;
+
+        // The loaded file replaces whatever is on screen
+        pendingOutput.clear();
+        clearSearchHits();
+        logModel->clear();
+        diagnosticModel->clear();
+        updateDiagnosticSummary();
+        progressBar->setValue(0);
 
-        // Start process
-        process->start("/bin/bash", arguments);
-        
-        if (!process->waitForStarted()) {
-            appendOutput("ERROR: Failed to start installation process!\n", Qt::red);
-            resetUI();
+        QString errorString;
+        if (!logLoader->open(fileName, &errorString)) {
+            QMessageBox::warning(this, "Open Log", QString("Cannot open %1:\n%2").arg(fileName, errorString));
+            return;
         }
+        loadTimer.start();
+        statusLabel->setText(QString("Loading %1...").arg(QFileInfo(fileName).fileName()));
     }
 
-    void stopInstallation()
+    void logLinesLoaded(const LogLineBatch &lines)
     {
-        if (process && process->state() != QProcess::NotRunning) {
-            appendOutput("\n=== Stopping installation... ===\n", Qt::red);
-            process->kill();
-            process->waitForFinished();
-            appendOutput("Installation stopped by user.\n", Qt::red);
-        }
-        resetUI();
+        pendingOutput.append(lines);
+        scheduleFlush();
     }
 
-    void handleStdout()
+    void updateLoadProgress(qint64 bytesLoaded, qint64 bytesTotal)
     {
-        QByteArray data = process->readAllStandardOutput();
-        QString output = QString::fromUtf8(data);
-        
-        // Parse and color-code output
-        QStringList lines = output.split('\n');
-        for (const QString &line : lines) {
-            if (line.isEmpty()) continue;
-            
-            QColor color = Qt::black;
-            
-            if (line.contains("[INFO]") || line.contains("Building") || line.contains("Configuring")) {
-                color = Qt::blue;
-            } else if (line.contains("[SUCCESS]") || line.contains("successfully") || line.contains("Complete")) {
-                color = Qt::darkGreen;
-            } else if (line.contains("[WARNING]")) {
-                color = QColor(255, 140, 0); // Orange
-            } else if (line.contains("[ERROR]") || line.contains("error:") || line.contains("Error")) {
-                color = Qt::red;
-            } else if (line.contains("===")) {
-                color = Qt::darkCyan;
-            }
-            
-            appendOutput(line + "\n", color);
+        progressBar->setValue(bytesTotal > 0 ? int(bytesLoaded * ProgressScale / bytesTotal) : ProgressScale);
+    }
+
+    void logLoadFinished()
+    {
+        flushOutput();
+        progressBar->setValue(ProgressScale);
+        statusLabel->setText(QString("Loaded %1 lines in %2 ms").arg(logModel->rowCount()).arg(loadTimer.elapsed()));
+    }
+
+    void updateProgress(double percent, int stepsDone, int stepsTotal)
+    {
+        eta.setSteps(stepsDone, stepsTotal);
+
+        const int value = int(percent * ProgressScale / 100);
+        if (value <= progressBar->value()) return;
+
+        progressBar->setValue(value);
+        progressText = QString("Progress: %1%").arg(percent, 0, 'f', 1);
+        if (stepsTotal > 0) {
+            progressText += QString(" (step %1 of %2)").arg(stepsDone).arg(stepsTotal);
         }
-        
-        // Update progress (simple heuristic)
-        updateProgress(output);
+        updateEta();
     }
 
-    void handleStderr()
+    void updateEta()
     {
-        QByteArray data = process->readAllStandardError();
-        QString output = QString::fromUtf8(data);
-        appendOutput(output, QColor(200, 0, 0)); // Dark red for errors
+        QString status = progressText;
+        const qint64 nowUs = sessionClock.elapsedUs();
+        const double phaseLeft = eta.phaseRemaining(phaseHistory, nowUs);
+        if (phaseLeft >= 0) {
+            status += QString(" - phase %1 left, %2 in total")
+                .arg(EtaEstimator::formatDuration(phaseLeft),
+                     EtaEstimator::formatDuration(eta.totalRemaining(phaseHistory, nowUs)));
+        }
+        statusLabel->setText(status);
     }
 
     void processFinished(int exitCode, QProcess::ExitStatus exitStatus)
     {
-        if (exitStatus == QProcess::CrashExit) {
-            appendOutput("\n=== Process crashed ===\n", Qt::red);
+        running = false;
+
+        // The daemon sent every line, its verdict included, before finished()
+        while (drainLines()) {}
+        flushOutput();
+
+        if (stopRequested || exitStatus == QProcess::CrashExit) {
+            // Already reported in the log
         } else if (exitCode == 0) {
-            appendOutput("\n=== Installation completed successfully! ===\n", Qt::darkGreen);
-            progressBar->setValue(100);
+            progressBar->setValue(ProgressScale);
             QMessageBox::information(this, "Success", "Qt6 installation completed successfully!");
         } else {
-            appendOutput(QString("\n=== Installation failed with exit code %1 ===\n").arg(exitCode), Qt::red);
             QMessageBox::critical(this, "Installation Failed", 
                 QString("Installation failed with exit code %1\nCheck the output for details.").arg(exitCode));
         }
@@ -154,11 +282,156 @@ private slots:
         resetUI();
     }
 
+    void flushOutput()
+    {
+        flushTimer->stop();
+
+        // Bounded per frame so a backlog never starves input handling
+        if (drainLines()) {
+            scheduleFlush();
+        }
+        if (pendingOutput.isEmpty()) return;
+
+        // Our own messages may be queued ahead of script lines stamped earlier
+        auto bySequence = [](const LogLine &a, const LogLine &b) { return a.sequence < b.sequence; };
+        if (!std::is_sorted(pendingOutput.cbegin(), pendingOutput.cend(), bySequence)) {
+            std::stable_sort(pendingOutput.begin(), pendingOutput.end(), bySequence);
+        }
+
+        // Follow the tail only if the user hasn't scrolled away from it
+        QScrollBar *scrollBar = outputView->verticalScrollBar();
+        const bool atBottom = scrollBar->value() == scrollBar->maximum();
+        QScrollBar *filterScrollBar = filterView->verticalScrollBar();
+        const bool filterAtBottom = filterScrollBar->value() == filterScrollBar->maximum();
+
+        // One row insertion per flush, not per line
+        eta.addLines(pendingOutput);
+        const int diagnosticTotal = diagnosticModel->totalCount();
+        diagnosticModel->addLines(pendingOutput, logModel->rowCount());
+        logModel->appendLines(pendingOutput);
+        pendingOutput.clear();
+
+        if (diagnosticModel->totalCount() != diagnosticTotal) {
+            updateDiagnosticSummary();
+        }
+
+        if (atBottom) {
+            outputView->scrollToBottom();
+        }
+        if (filterAtBottom) {
+            filterView->scrollToBottom();
+        }
+    }
+
+    void runSearch()
+    {
+        searchTimer->stop();
+        clearSearchHits();
+        searchedRows = logModel->rowCount();
+
+        const QString pattern = searchEdit->text();
+        if (pattern.isEmpty()) return;
+
+        // Hits come in chunk by chunk through searchHitsChanged()
+        searchClock.start();
+        const LogSearch::Mode mode = regexCheckbox->isChecked() ? LogSearch::Mode::Regex : LogSearch::Mode::Substring;
+        QString errorString;
+        if (!logSearch->start(logModel->store(), pattern, mode, &errorString)) {
+            searchStatusLabel->setText(QString("Invalid pattern: %1").arg(errorString));
+            return;
+        }
+        searchStatusLabel->setText("Searching...");
+    }
+
+    void searchHitsChanged()
+    {
+        // The first hits found are shown right away; after that the view stays put
+        if (currentHit < 0) {
+            showHit(0);
+        } else {
+            currentHit = logSearch->indexOfHit(currentHitRow);
+            updateSearchStatus();
+        }
+    }
+
+    void searchFinished()
+    {
+        searchMs = searchClock.elapsed();
+        if (logSearch->hitCount() == 0) {
+            searchStatusLabel->setText("No matches");
+        } else {
+            updateSearchStatus();
+        }
+    }
+
+    void findNext()
+    {
+        // New output or a pending edit makes the current hits stale
+        if (searchTimer->isActive() || searchedRows != logModel->rowCount()) {
+            runSearch();
+        } else {
+            showHit(currentHit + 1);
+        }
+    }
+
+    void findPrevious()
+    {
+        if (searchTimer->isActive() || searchedRows != logModel->rowCount()) {
+            runSearch();
+        } else {
+            showHit(currentHit - 1);
+        }
+    }
+
+    void applyFilter(int comboIndex)
+    {
+        if (comboIndex < 0) return;
+
+        const QVariant phase = filterCombo->itemData(comboIndex, PhaseRole);
+        if (phase.isValid()) {
+            filterModel->setPhaseFilter(phase.toInt());
+        } else {
+            filterModel->setClassFilter(LineClass(filterCombo->itemData(comboIndex).toInt()));
+        }
+    }
+
+    void updatePhaseFilters()
+    {
+        // Phases only grow during a run and start over with a new one
+        const QList<LogModel::Phase> &phases = logModel->phases();
+        while (filterCombo->count() > ClassFilterCount + phases.size()) {
+            filterCombo->removeItem(filterCombo->count() - 1);
+        }
+        for (qsizetype phase = filterCombo->count() - ClassFilterCount; phase < phases.size(); ++phase) {
+            filterCombo->addItem(QString("Phase: %1").arg(phases.at(phase).title));
+            filterCombo->setItemData(filterCombo->count() - 1, int(phase), PhaseRole);
+        }
+    }
+
+    void jumpToFilteredRow(const QModelIndex &filterIndex)
+    {
+        jumpToRow(filterModel->sourceRow(filterIndex.row()));
+    }
+
+    void jumpToDiagnostic(const QModelIndex &proxyIndex)
+    {
+        const int row = diagnosticModel->firstRow(diagnosticProxy->mapToSource(proxyIndex));
+        if (row >= 0) {
+            jumpToRow(row);
+        }
+    }
+
+    void applyGrouping(int comboIndex)
+    {
+        diagnosticModel->setGrouping(DiagnosticModel::Grouping(diagnosticGroupCombo->itemData(comboIndex).toInt()));
+    }
+
 private:
+
     void setupUI()
     {
         setWindowTitle("Qt6 Cross-Compilation Installer for macOS");
-        resize(900, 700);
+        resize(1200, 700);
 
         QWidget *centralWidget = new QWidget(this);
         QVBoxLayout *mainLayout = new QVBoxLayout(centralWidget);
@@ -212,32 +485,201 @@ private:
         connect(startButton, &QPushButton::clicked, this, &Qt6InstallerGUI::startInstallation);
         buttonLayout->addWidget(startButton);
 
+        resumeButton = new QPushButton("Resume from failed phase");
+        resumeButton->setEnabled(false);
+        connect(resumeButton, &QPushButton::clicked, this, &Qt6InstallerGUI::resumeInstallation);
+        buttonLayout->addWidget(resumeButton);
+
         stopButton = new QPushButton("Stop");
         stopButton->setEnabled(false);
         stopButton->setStyleSheet("QPushButton { background-color: #f44336; color: white; padding: 8px; font-weight: bold; } QPushButton:hover { background-color: #da190b; }");
         connect(stopButton, &QPushButton::clicked, this, &Qt6InstallerGUI::stopInstallation);
         buttonLayout->addWidget(stopButton);
 
+        pauseButton = new QPushButton("Pause");
+        pauseButton->setEnabled(false);
+        pauseButton->setToolTip("Stop every build process for now and continue later");
+        connect(pauseButton, &QPushButton::clicked, this, &Qt6InstallerGUI::togglePause);
+        buttonLayout->addWidget(pauseButton);
+
+        openLogButton = new QPushButton("Open Log...");
+        connect(openLogButton, &QPushButton::clicked, this, &Qt6InstallerGUI::openLogFile);
+        buttonLayout->addWidget(openLogButton);
+
         mainLayout->addLayout(buttonLayout);
 
         // Progress bar
         progressBar = new QProgressBar();
         progressBar->setMinimum(0);
-        progressBar->setMaximum(100);
+        progressBar->setMaximum(ProgressScale);
         progressBar->setValue(0);
         progressBar->setTextVisible(true);
         mainLayout->addWidget(progressBar);
 
         // Output text area
+        QHBoxLayout *outputHeaderLayout = new QHBoxLayout();
         QLabel *outputLabel = new QLabel("Installation Output:");
         outputLabel->setStyleSheet("font-weight: bold;");
-        mainLayout->addWidget(outputLabel);
+        outputHeaderLayout->addWidget(outputLabel);
+        outputHeaderLayout->addStretch();
+
+        timestampsCheckbox = new QCheckBox("Show timestamps");
+        outputHeaderLayout->addWidget(timestampsCheckbox);
+
+        QToolButton *filterPaneButton = new QToolButton();
+        outputHeaderLayout->addWidget(filterPaneButton);
+        mainLayout->addLayout(outputHeaderLayout);
+
+        // Search bar; hits are ranked errors first, Enter steps through them
+        QHBoxLayout *searchLayout = new QHBoxLayout();
+        searchEdit = new QLineEdit();
+        searchEdit->setPlaceholderText("Search output (Enter for next match)");
+        searchEdit->setClearButtonEnabled(true);
+        searchLayout->addWidget(searchEdit);
+
+        regexCheckbox = new QCheckBox("Regex");
+        searchLayout->addWidget(regexCheckbox);
+
+        QPushButton *previousButton = new QPushButton("Previous");
+        searchLayout->addWidget(previousButton);
+        QPushButton *nextButton = new QPushButton("Next");
+        searchLayout->addWidget(nextButton);
+
+        searchStatusLabel = new QLabel();
+        searchStatusLabel->setMinimumWidth(160);
+        searchLayout->addWidget(searchStatusLabel);
+        mainLayout->addLayout(searchLayout);
+
+        logSearch = new LogSearch(this);
+        connect(logSearch, &LogSearch::hitsChanged, this, &Qt6InstallerGUI::searchHitsChanged);
+        connect(logSearch, &LogSearch::finished, this, &Qt6InstallerGUI::searchFinished);
+
+        searchTimer = new QTimer(this);
+        searchTimer->setSingleShot(true);
+        searchTimer->setInterval(SearchDelayMs);
+        connect(searchTimer, &QTimer::timeout, this, &Qt6InstallerGUI::runSearch);
+        connect(searchEdit, &QLineEdit::textChanged, searchTimer, qOverload<>(&QTimer::start));
+        connect(regexCheckbox, &QCheckBox::toggled, searchTimer, qOverload<>(&QTimer::start));
+        connect(searchEdit, &QLineEdit::returnPressed, this, &Qt6InstallerGUI::findNext);
+        connect(nextButton, &QPushButton::clicked, this, &Qt6InstallerGUI::findNext);
+        connect(previousButton, &QPushButton::clicked, this, &Qt6InstallerGUI::findPrevious);
+
+        QShortcut *findShortcut = new QShortcut(QKeySequence::Find, this);
+        connect(findShortcut, &QShortcut::activated, this, [this]() {
+            searchEdit->setFocus();
+            searchEdit->selectAll();
+        });
+
+        logModel = new LogModel(this);
+        connect(timestampsCheckbox, &QCheckBox::toggled, logModel, &LogModel::setShowTimestamps);
+
+        // RAM kept for the newest part of the log; older chunks spill to disk
+        const int hotWindowMb = qEnvironmentVariableIntValue("QT6_INSTALLER_LOG_HOT_MB");
+        if (hotWindowMb > 0) {
+            logModel->store().setHotChunks(int(hotWindowMb * 1024LL * 1024 / LogStore::DefaultChunkSize));
+        }
+
+        // Uniform rows let the view lay out only the visible lines
+        outputView = new QListView();
+        outputView->setModel(logModel);
+        outputView->setItemDelegate(new LogDelegate(outputView));
+        outputView->setUniformItemSizes(true);
+        outputView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        outputView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+        outputView->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+        outputView->setFont(QFont("Monaco", 11));
+        outputView->setStyleSheet("QListView { background-color: #1e1e1e; color: #d4d4d4; border: 1px solid #444; }");
+        mainLayout->addWidget(outputView);
+
+        // Filter pane: errors, warnings, stderr or a single install phase
+        QDockWidget *filterDock = new QDockWidget("Filtered Output", this);
+        QWidget *filterWidget = new QWidget(filterDock);
+        QVBoxLayout *filterLayout = new QVBoxLayout(filterWidget);
+        filterLayout->setContentsMargins(0, 0, 0, 0);
+
+        filterCombo = new QComboBox();
+        filterCombo->addItem("Errors", int(LineClass::Error));
+        filterCombo->addItem("Warnings", int(LineClass::Warning));
+        filterCombo->addItem("Stderr", int(LineClass::Stderr));
+        filterLayout->addWidget(filterCombo);
+
+        filterModel = new LogFilterModel(logModel, this);
+        filterView = new QListView();
+        filterView->setModel(filterModel);
+        filterView->setItemDelegate(new LogDelegate(filterView));
+        filterView->setUniformItemSizes(true);
+        filterView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        filterView->setFont(outputView->font());
+        filterView->setStyleSheet(outputView->styleSheet());
+        filterView->setToolTip("Click a line to show it in the full output");
+        filterLayout->addWidget(filterView);
+
+        filterDock->setWidget(filterWidget);
+        addDockWidget(Qt::RightDockWidgetArea, filterDock);
+        filterPaneButton->setDefaultAction(filterDock->toggleViewAction());
+
+        connect(filterCombo, qOverload<int>(&QComboBox::currentIndexChanged), this, &Qt6InstallerGUI::applyFilter);
+        connect(logModel, &LogModel::phasesChanged, this, &Qt6InstallerGUI::updatePhaseFilters);
+        connect(filterView, &QListView::clicked, this, &Qt6InstallerGUI::jumpToFilteredRow);
+
+        // Diagnostics pane: distinct compiler and CMake diagnostics with counts
+        QDockWidget *diagnosticDock = new QDockWidget("Diagnostics", this);
+        QWidget *diagnosticWidget = new QWidget(diagnosticDock);
+        QVBoxLayout *diagnosticLayout = new QVBoxLayout(diagnosticWidget);
+        diagnosticLayout->setContentsMargins(0, 0, 0, 0);
+
+        QHBoxLayout *groupLayout = new QHBoxLayout();
+        groupLayout->addWidget(new QLabel("Group by:"));
+        diagnosticGroupCombo = new QComboBox();
+        diagnosticGroupCombo->addItem("None", int(DiagnosticModel::Grouping::None));
+        diagnosticGroupCombo->addItem("File", int(DiagnosticModel::Grouping::File));
+        diagnosticGroupCombo->addItem("Flag", int(DiagnosticModel::Grouping::Flag));
+        groupLayout->addWidget(diagnosticGroupCombo);
+        groupLayout->addStretch();
+        diagnosticSummaryLabel = new QLabel();
+        groupLayout->addWidget(diagnosticSummaryLabel);
+        diagnosticLayout->addLayout(groupLayout);
+
+        diagnosticModel = new DiagnosticModel(this);
+        diagnosticProxy = new QSortFilterProxyModel(this);
+        diagnosticProxy->setSourceModel(diagnosticModel);
+
+        QTreeView *diagnosticView = new QTreeView();
+        diagnosticView->setModel(diagnosticProxy);
+        diagnosticView->setSortingEnabled(true);
+        diagnosticView->sortByColumn(-1, Qt::AscendingOrder);
+        diagnosticView->setUniformRowHeights(true);
+        diagnosticView->setRootIsDecorated(false);
+        diagnosticView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        diagnosticView->header()->setStretchLastSection(true);
+        diagnosticView->setToolTip("Click a diagnostic to show its first occurrence");
+        diagnosticLayout->addWidget(diagnosticView);
+
+        diagnosticDock->setWidget(diagnosticWidget);
+        addDockWidget(Qt::RightDockWidgetArea, diagnosticDock);
+        tabifyDockWidget(filterDock, diagnosticDock);
+
+        // Resources pane: CPU, memory and disk use of the whole build tree (Linux only)
+        if (ResourceSampler::isSupported()) {
+            QDockWidget *resourceDock = new QDockWidget("Resources", this);
+            resourceMonitor = new ResourceMonitor(resourceDock);
+            resourceDock->setWidget(resourceMonitor);
+            addDockWidget(Qt::RightDockWidgetArea, resourceDock);
+            tabifyDockWidget(diagnosticDock, resourceDock);
+        }
+        filterDock->raise();
+
+        connect(diagnosticGroupCombo, qOverload<int>(&QComboBox::currentIndexChanged), this, [this, diagnosticView](int comboIndex) {
+            applyGrouping(comboIndex);
+            diagnosticView->setRootIsDecorated(comboIndex > 0);
+        });
+        connect(diagnosticView, &QTreeView::clicked, this, &Qt6InstallerGUI::jumpToDiagnostic);
 
-        outputText = new QTextEdit();
-        outputText->setReadOnly(true);
-        outputText->setFont(QFont("Monaco", 11));
-        outputText->setStyleSheet("QTextEdit { background-color: #1e1e1e; color: #d4d4d4; border: 1px solid #444; }");
-        mainLayout->addWidget(outputText);
+        // Output is coalesced and flushed at most once per frame
+        flushTimer = new QTimer(this);
+        flushTimer->setSingleShot(true);
+        flushTimer->setInterval(FlushIntervalMs);
+        connect(flushTimer, &QTimer::timeout, this, &Qt6InstallerGUI::flushOutput);
 
         // Status bar
         statusLabel = new QLabel("Ready to install");
@@ -249,79 +691,276 @@ private:
 
     void setupProcess()
     {
-        process = new QProcess(this);
-        connect(process, &QProcess::readyReadStandardOutput, this, &Qt6InstallerGUI::handleStdout);
-        connect(process, &QProcess::readyReadStandardError, this, &Qt6InstallerGUI::handleStderr);
-        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-                this, &Qt6InstallerGUI::processFinished);
+        // The build runs in the daemon; its lines are decoded on this thread
+        workerThread = new QThread(this);
+        daemon = new DaemonClient(&lineQueue, &sessionClock);
+        daemon->moveToThread(workerThread);
+
+        connect(daemon, &DaemonClient::linesReady, this, &Qt6InstallerGUI::scheduleFlush);
+        connect(daemon, &DaemonClient::attached, this, &Qt6InstallerGUI::daemonAttached);
+        connect(daemon, &DaemonClient::detached, this, &Qt6InstallerGUI::daemonDetached);
+        connect(daemon, &DaemonClient::progressChanged, this, &Qt6InstallerGUI::updateProgress);
+        connect(daemon, &DaemonClient::pausedChanged, this, &Qt6InstallerGUI::processPausedChanged);
+        connect(daemon, &DaemonClient::failedToStart, this, &Qt6InstallerGUI::processFailedToStart);
+        connect(daemon, &DaemonClient::finished, this, &Qt6InstallerGUI::processFinished);
+
+        // Sampling shares the worker thread; it reads a few small /proc files a second
+        resourceSampler = new ResourceSampler();
+        resourceSampler->moveToThread(workerThread);
+        connect(daemon, &DaemonClient::processStarted, resourceSampler, &ResourceSampler::start);
+        connect(daemon, &DaemonClient::finished, resourceSampler, &ResourceSampler::stop);
+        connect(daemon, &DaemonClient::detached, resourceSampler, &ResourceSampler::stop);
+        connect(resourceSampler, &ResourceSampler::sampled, this, &Qt6InstallerGUI::addResourceSample);
+
+        workerThread->start();
+
+        // Recomputed every second, since the ETA moves even when the output is quiet
+        etaTimer = new QTimer(this);
+        etaTimer->setInterval(EtaIntervalMs);
+        connect(etaTimer, &QTimer::timeout, this, &Qt6InstallerGUI::updateEta);
+
+        // Saved logs are parsed on a thread pool and fed through the same flush path
+        logLoader = new LogFileLoader(this);
+        connect(logLoader, &LogFileLoader::linesLoaded, this, &Qt6InstallerGUI::logLinesLoaded);
+        connect(logLoader, &LogFileLoader::progressChanged, this, &Qt6InstallerGUI::updateLoadProgress);
+        connect(logLoader, &LogFileLoader::finished, this, &Qt6InstallerGUI::logLoadFinished);
+
+        // A build left running by an earlier window shows up right away
+        QMetaObject::invokeMethod(daemon, &DaemonClient::attach);
     }
 
-    void appendOutput(const QString &text, const QColor &color)
+    // Moves classified batches from the daemon queue into pendingOutput.
+    // Returns true if the per-frame budget ran out with lines still queued.
+    bool drainLines()
     {
-        QTextCharFormat format;
-        format.setForeground(QBrush(color));
-        
-        QTextCursor cursor = outputText->textCursor();
-        cursor.movePosition(QTextCursor::End);
-        cursor.insertText(text, format);
-        
-        outputText->setTextCursor(cursor);
-        outputText->ensureCursorVisible();
-        
-        // Auto-scroll
-        QScrollBar *scrollBar = outputText->verticalScrollBar();
-        scrollBar->setValue(scrollBar->maximum());
+        daemon->acknowledgeLines();
+
+        LogLineBatch batch;
+        qsizetype drained = 0;
+        while (drained < MaxLinesPerFlush && lineQueue.tryPop(batch)) {
+            drained += batch.size();
+            pendingOutput.append(batch);
+        }
+        return !lineQueue.isEmpty();
     }
 
-    void updateProgress(const QString &output)
+    void jumpToRow(int row)
     {
-        // Simple progress estimation based on output keywords
-        static int currentProgress = 0;
-        
-        if (output.contains("Checking prerequisites")) currentProgress = 5;
-        else if (output.contains("llvm-mingw")) currentProgress = 10;
-        else if (output.contains("Qt6 source")) currentProgress = 15;
-        else if (output.contains("Configuring Qt6 host")) currentProgress = 20;
-        else if (output.contains("Building Qt6 host")) currentProgress = 30;
-        else if (output.contains("Installing Qt6 host")) currentProgress = 50;
-        else if (output.contains("Configuring Qt6 Windows")) currentProgress = 55;
-        else if (output.contains("Building Qt6 Windows")) currentProgress = 70;
-        else if (output.contains("Installing Qt6 Windows")) currentProgress = 85;
-        else if (output.contains("test application")) currentProgress = 95;
-        else if (output.contains("Installation Complete")) currentProgress = 100;
-        
-        if (currentProgress > progressBar->value()) {
-            progressBar->setValue(currentProgress);
-            statusLabel->setText(QString("Progress: %1%").arg(currentProgress));
+        const QModelIndex index = logModel->index(row);
+        outputView->setCurrentIndex(index);
+        outputView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+    }
+
+    void updateDiagnosticSummary()
+    {
+        diagnosticSummaryLabel->setText(QString("%1 distinct, %2 total")
+            .arg(diagnosticModel->distinctCount()).arg(diagnosticModel->totalCount()));
+    }
+
+    void showHit(int hit)
+    {
+        const int count = logSearch->hitCount();
+        if (count == 0) {
+            searchStatusLabel->setText(logSearch->isRunning() ? "Searching..." : "No matches");
+            return;
+        }
+
+        currentHit = (hit + count) % count;
+        currentHitRow = logSearch->hit(currentHit);
+        jumpToRow(currentHitRow);
+        updateSearchStatus();
+    }
+
+    void updateSearchStatus()
+    {
+        if (logSearch->isRunning()) {
+            searchStatusLabel->setText(QString("%1 of %2 so far...").arg(currentHit + 1).arg(logSearch->hitCount()));
+        } else {
+            searchStatusLabel->setText(QString("%1 of %2 (%3 ms)").arg(currentHit + 1).arg(logSearch->hitCount()).arg(searchMs));
+        }
+    }
+
+    void clearSearchHits()
+    {
+        logSearch->cancel();
+        currentHit = -1;
+        currentHitRow = -1;
+        searchedRows = -1;
+        searchStatusLabel->clear();
+    }
+
+    void scheduleFlush()
+    {
+        if (!flushTimer->isActive()) {
+            flushTimer->start();
         }
     }
 
+    // A non-empty resumeFrom is handed to the script as RESUME_FROM
+    void runScript(const QString &resumeFrom)
+    {
+        if (scriptPath.isEmpty()) {
+            QMessageBox::warning(this, "No Script", "Please select install.sh first!");
+            return;
+        }
+
+        // Disable controls
+        startButton->setEnabled(false);
+        resumeButton->setEnabled(false);
+        stopButton->setEnabled(true);
+        pauseButton->setEnabled(InstallWorker::canPause());
+        browseButton->setEnabled(false);
+        openLogButton->setEnabled(false);
+        qmlCheckbox->setEnabled(false);
+        running = true;
+        stopRequested = false;
+        progressBar->setValue(0);
+
+        // Clear output; the daemon starts its clock over as well
+        logLoader->cancel();
+        pendingOutput.clear();
+        clearSearchHits();
+        logModel->clear();
+        sessionClock.restart();
+        diagnosticModel->clear();
+        updateDiagnosticSummary();
+        if (resourceMonitor) resourceMonitor->clear();
+
+        // Phase timings of earlier runs drive the ETA; the daemon records this run
+        const int parallelJobs = qEnvironmentVariableIsSet("PARALLEL_JOBS")
+            ? qMax(1, qEnvironmentVariableIntValue("PARALLEL_JOBS")) : DefaultParallelJobs;
+        phaseHistory.load(PhaseHistory::defaultPath());
+        eta.start({QThread::idealThreadCount(), parallelJobs, qmlCheckbox->isChecked()});
+        progressText = "Starting...";
+        etaTimer->start();
+
+        // Prepare process
+        QStringList arguments;
+        arguments << scriptPath;
+
+        // Set environment variable for QML choice
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert("BUILD_QML", qmlCheckbox->isChecked() ? "y" : "n");
+        env.insert("PARALLEL_JOBS", QString::number(parallelJobs));
+        if (!resumeFrom.isEmpty()) env.insert("RESUME_FROM", resumeFrom);
+
+        // The daemon runs the script and writes the session log
+        QMetaObject::invokeMethod(daemon, [this, arguments, env]() {
+            daemon->start("/bin/bash", arguments, env);
+        });
+    }
+
     void resetUI()
     {
         startButton->setEnabled(true);
         stopButton->setEnabled(false);
+        pauseButton->setEnabled(false);
+        pauseButton->setText("Pause");
         browseButton->setEnabled(true);
+        openLogButton->setEnabled(true);
         qmlCheckbox->setEnabled(true);
+        etaTimer->stop();
         statusLabel->setText("Ready");
+        updateResumeButton();
+    }
+
+    // Offered while the last run's checkpoint names the phase it failed in
+    void updateResumeButton()
+    {
+        InstallCheckpoint checkpoint;
+        checkpoint.load(InstallCheckpoint::defaultPath());
+        const QString phase = checkpoint.failedPhase();
+        resumeButton->setEnabled(!running && !scriptPath.isEmpty() && !phase.isEmpty());
+        resumeButton->setToolTip(phase.isEmpty()
+            ? QString("The last run did not fail in a phase")
+            : QString("Start again at \"%1\"; earlier phases and the build directories are kept. "
+                      "With QML Support changed, everything runs again.").arg(checkpoint.failedTitle()));
     }
 
     // UI Elements
     QPushButton *startButton;
+    QPushButton *resumeButton;
     QPushButton *stopButton;
+    QPushButton *pauseButton;
     QPushButton *browseButton;
-    QTextEdit *outputText;
+    QPushButton *openLogButton;
+    QListView *outputView;
+    LogModel *logModel;
     QProgressBar *progressBar;
     QCheckBox *qmlCheckbox;
+    QCheckBox *timestampsCheckbox;
+    QLineEdit *searchEdit;
+    QCheckBox *regexCheckbox;
+    QLabel *searchStatusLabel;
+    QComboBox *filterCombo;
+    QListView *filterView;
+    LogFilterModel *filterModel;
+    QComboBox *diagnosticGroupCombo;
+    QLabel *diagnosticSummaryLabel;
+    DiagnosticModel *diagnosticModel;
+    QSortFilterProxyModel *diagnosticProxy;
+    ResourceMonitor *resourceMonitor = nullptr;
     QLabel *scriptPathLabel;
     QLabel *statusLabel;
     
+    // Tenths of a percent, so build counters move the bar smoothly
+    static constexpr int ProgressScale = 1000;
+
+    // Phase timing
+    static constexpr int DefaultParallelJobs = 4;   // install.sh's own default
+    static constexpr int EtaIntervalMs = 1000;
+    QTimer *etaTimer;
+    QString progressText;
+    PhaseHistory phaseHistory;
+    EtaEstimator eta;
+
+    // Output batching
+    static constexpr int FlushIntervalMs = 16;
+    static constexpr qsizetype MaxLinesPerFlush = 50000;
+    QTimer *flushTimer;
+    LogLineBatch pendingOutput;
+
+    // Filter pane
+    static constexpr int ClassFilterCount = 3;
+    static constexpr int PhaseRole = Qt::UserRole + 1;
+
+    // Search
+    static constexpr int SearchDelayMs = 150;
+    QTimer *searchTimer;
+    LogSearch *logSearch;
+    QElapsedTimer searchClock;
+    int currentHit = -1;
+    int currentHitRow = -1;
+    int searchedRows = -1;
+    qint64 searchMs = 0;
+
     // Process
-    QProcess *process;
+    static constexpr std::size_t LineQueueCapacity = 1024;
+    LogBatchQueue lineQueue;
+    SessionClock sessionClock;
+    QThread *workerThread;
+    DaemonClient *daemon;
+    ResourceSampler *resourceSampler;
+    LogFileLoader *logLoader;
+    QElapsedTimer loadTimer;
+    bool running = false;
+    bool stopRequested = false;
+    bool paused = false;
     QString scriptPath;
 };
 
 int main(int argc, char *argv[])
 {
+    // Decided before any application object exists, so these modes never touch widgets
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--headless") == 0) {
+            return HeadlessRunner::run(argc, argv);
+        }
+        if (qstrcmp(argv[i], "--daemon") == 0) {
+            return InstallDaemon::run(argc, argv);
+        }
+    }
+
     QApplication app(argc, argv);
 
     Qt6InstallerGUI window;
@@ -0,0 +1,163 @@
+#include "phasehistory.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace
+{
+
+constexpr int FormatVersion = 1;
+
+// Each newer sample counts this much more than the one before it
+constexpr double RecencyWeight = 1.5;
+
+int parallelism(const PhaseHistory::Traits &traits)
+{
+    return qMax(1, qMin(traits.cores, traits.jobs));
+}
+
+} // namespace
+
+QString PhaseHistory::defaultPath()
+{
+    const QString overridePath = qEnvironmentVariable("QT6_INSTALLER_STATS");
+    if (!overridePath.isEmpty()) return overridePath;
+
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/phase-stats.json";
+}
+
+bool PhaseHistory::load(const QString &path, QString *errorString)
+{
+    phases.clear();
+
+    QFile file(path);
+    if (!file.exists()) return true;
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!document.isObject()) {
+        if (errorString) *errorString = QString("%1: %2").arg(path, parseError.errorString());
+        return false;
+    }
+
+    const QJsonObject root = document.object();
+    if (root.value("version").toInt() != FormatVersion) {
+        if (errorString) *errorString = QString("%1: unknown format version").arg(path);
+        return false;
+    }
+
+    const QJsonObject phaseObjects = root.value("phases").toObject();
+    for (auto it = phaseObjects.constBegin(); it != phaseObjects.constEnd(); ++it) {
+        bool ok = false;
+        const int milestone = it.key().toInt(&ok);
+        if (!ok) continue;
+
+        const QJsonObject object = it.value().toObject();
+        Phase phase;
+        phase.title = object.value("title").toString();
+        for (const QJsonValue &value : object.value("samples").toArray()) {
+            const QJsonObject sample = value.toObject();
+            const double seconds = sample.value("seconds").toDouble(-1);
+            if (seconds < 0) continue;
+            phase.samples.append({seconds, sample.value("paused").toDouble(),
+                                  {sample.value("cores").toInt(1), sample.value("jobs").toInt(1),
+                                   sample.value("qml").toBool()}});
+        }
+        if (!phase.samples.isEmpty()) {
+            phases.insert(milestone, phase);
+        }
+    }
+    return true;
+}
+
+bool PhaseHistory::save(const QString &path, QString *errorString) const
+{
+    QJsonObject phaseObjects;
+    for (auto it = phases.constBegin(); it != phases.constEnd(); ++it) {
+        QJsonArray samples;
+        for (const Sample &sample : it->samples) {
+            samples.append(QJsonObject{
+                {"seconds", sample.seconds},
+                {"paused", sample.pausedSeconds},
+                {"cores", sample.traits.cores},
+                {"jobs", sample.traits.jobs},
+                {"qml", sample.traits.qml},
+            });
+        }
+        phaseObjects.insert(QString::number(it.key()), QJsonObject{{"title", it->title}, {"samples", samples}});
+    }
+    const QJsonObject root{{"version", FormatVersion}, {"phases", phaseObjects}};
+
+    // Written aside and renamed, so a crash never leaves half a file
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(QJsonDocument(root).toJson()) < 0
+        || !file.commit()) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void PhaseHistory::record(int milestone, const QString &title, double seconds, double pausedSeconds,
+                          const Traits &traits)
+{
+    Phase &phase = phases[milestone];
+    phase.title = title;
+    phase.samples.append({seconds, pausedSeconds, traits});
+    if (phase.samples.size() > MaxSamples) {
+        phase.samples.remove(0, phase.samples.size() - MaxSamples);
+    }
+}
+
+double PhaseHistory::predict(int milestone, const Traits &traits) const
+{
+    const auto it = phases.constFind(milestone);
+    if (it == phases.constEnd()) return -1;
+
+    // Same machine and settings first; anything else only as a scaled fallback
+    double sum = 0;
+    double weights = 0;
+    double weight = 1;
+    for (const Sample &sample : it->samples) {
+        if (sample.traits == traits) {
+            sum += sample.seconds * weight;
+            weights += weight;
+        }
+        weight *= RecencyWeight;
+    }
+    if (weights > 0) return sum / weights;
+
+    weight = 1;
+    for (const Sample &sample : it->samples) {
+        sum += sample.seconds * parallelism(sample.traits) / parallelism(traits) * weight;
+        weights += weight;
+        weight *= RecencyWeight;
+    }
+    return sum / weights;
+}
+
+double PhaseHistory::predictAfter(int milestone, const Traits &traits) const
+{
+    double total = 0;
+    for (auto it = phases.upperBound(milestone); it != phases.constEnd(); ++it) {
+        // A phase only ever seen in QML builds will not run without QML
+        bool needed = traits.qml;
+        for (const Sample &sample : it->samples) {
+            needed = needed || !sample.traits.qml;
+        }
+        if (needed) total += predict(it.key(), traits);
+    }
+    return total;
+}
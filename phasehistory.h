@@ -0,0 +1,68 @@
+#ifndef PHASEHISTORY_H
+#define PHASEHISTORY_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+
+// Durations of past install phases on this machine, kept in a JSON file.
+//
+// Phases are keyed by their milestone percentage, which is stable across
+// runs. Every sample carries the traits of the run that produced it: core
+// count, PARALLEL_JOBS and whether QML was built. A prediction averages the
+// samples taken with the same traits, newest weighted highest; if there are
+// none, samples from other settings are scaled by their effective
+// parallelism. Time spent paused is excluded from a sample and stored next
+// to it. Only the newest MaxSamples per phase are kept.
+class PhaseHistory
+{
+public:
+    struct Traits
+    {
+        int cores = 1;
+        int jobs = 1;
+        bool qml = false;
+
+        bool operator==(const Traits &other) const
+        {
+            return cores == other.cores && jobs == other.jobs && qml == other.qml;
+        }
+    };
+
+    static constexpr int MaxSamples = 10;
+
+    // $QT6_INSTALLER_STATS, or phase-stats.json in the app's data directory
+    static QString defaultPath();
+
+    // A missing file is an empty history, not an error
+    bool load(const QString &path, QString *errorString = nullptr);
+    bool save(const QString &path, QString *errorString = nullptr) const;
+
+    void record(int milestone, const QString &title, double seconds, double pausedSeconds, const Traits &traits);
+
+    // Expected duration in seconds, or -1 if the phase was never timed
+    double predict(int milestone, const Traits &traits) const;
+
+    // Summed predictions for every known phase after the given milestone
+    double predictAfter(int milestone, const Traits &traits) const;
+
+    bool isEmpty() const { return phases.isEmpty(); }
+
+private:
+    struct Sample
+    {
+        double seconds = 0;
+        double pausedSeconds = 0;
+        Traits traits;
+    };
+
+    struct Phase
+    {
+        QString title;
+        QList<Sample> samples;      // oldest first
+    };
+
+    QMap<int, Phase> phases;
+};
+
+#endif // PHASEHISTORY_H
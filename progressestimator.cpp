@@ -0,0 +1,111 @@
+#include "progressestimator.h"
+
+#include <algorithm>
+
+namespace
+{
+
+// Reads decimal digits at *pos; false if there are none or too many
+bool readNumber(QByteArrayView line, qsizetype *pos, int *number)
+{
+    const qsizetype begin = *pos;
+    int value = 0;
+    while (*pos < line.size() && line[*pos] >= '0' && line[*pos] <= '9') {
+        if (*pos - begin >= 9) return false;
+        value = value * 10 + (line[*pos] - '0');
+        ++*pos;
+    }
+    *number = value;
+    return *pos > begin;
+}
+
+} // namespace
+
+void ProgressEstimator::setMilestones(QList<int> list)
+{
+    list.append(100);
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+    milestones = list;
+    reset();
+}
+
+void ProgressEstimator::reset()
+{
+    phaseStart = 0;
+    phaseEnd = milestones.isEmpty() ? 100 : milestones.first();
+    done = 0;
+    total = 0;
+    estimate = 0;
+}
+
+bool ProgressEstimator::reachMilestone(int percent)
+{
+    // Same rule as the phase list: only a higher milestone is a new phase
+    if (percent <= phaseStart) return false;
+
+    phaseStart = percent;
+    phaseEnd = 100;
+    for (const int next : milestones) {
+        if (next > percent) {
+            phaseEnd = next;
+            break;
+        }
+    }
+    done = 0;
+    total = 0;
+
+    if (percent <= estimate) return false;
+    estimate = percent;
+    return true;
+}
+
+bool ProgressEstimator::addStatusLine(QByteArrayView line)
+{
+    int lineDone = 0;
+    int lineTotal = 0;
+    if (!parseCounter(line, &lineDone, &lineTotal)) return false;
+
+    done = lineDone;
+    total = lineTotal;
+
+    const double value = phaseStart + (phaseEnd - phaseStart) * double(done) / total;
+    if (value <= estimate) return false;
+    estimate = value;
+    return true;
+}
+
+bool ProgressEstimator::completePhase()
+{
+    if (phaseEnd <= estimate) return false;
+    estimate = phaseEnd;
+    return true;
+}
+
+bool ProgressEstimator::parseCounter(QByteArrayView line, int *done, int *total)
+{
+    if (line.size() < 4 || line[0] != '[') return false;
+
+    qsizetype pos = 1;
+    while (pos < line.size() && line[pos] == ' ') ++pos;
+
+    int first = 0;
+    if (!readNumber(line, &pos, &first) || pos >= line.size()) return false;
+
+    if (line[pos] == '%') {
+        if (pos + 1 >= line.size() || line[pos + 1] != ']' || first > 100) return false;
+        *done = first;
+        *total = 100;
+        return true;
+    }
+
+    int second = 0;
+    if (line[pos] != '/') return false;
+    ++pos;
+    if (!readNumber(line, &pos, &second) || pos >= line.size() || line[pos] != ']') return false;
+    if (second == 0 || first > second) return false;
+
+    *done = first;
+    *total = second;
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef PROGRESSESTIMATOR_H
+#define PROGRESSESTIMATOR_H
+
+#include <QByteArrayView>
+#include <QList>
+
+// Turns milestones and build step counters into one moving percentage.
+//
+// A milestone (e.g. 30 for "Building Qt6 host") opens a phase that runs up
+// to the next higher milestone. Inside a phase, ninja's "[done/total]" and
+// make's "[ nn%]" status lines move the estimate through that range in
+// proportion to the steps finished. A phase may run several builds in a
+// row; the estimate never moves backwards when a new build restarts its
+// counter, and it only reaches the next milestone when that milestone is
+// actually seen or the script reports the phase finished.
+class ProgressEstimator
+{
+public:
+    // Milestones known to the classifier; 100 is always the last one
+    void setMilestones(QList<int> milestones);
+    void reset();
+
+    // Both return true if the estimate moved
+    bool reachMilestone(int percent);
+    bool addStatusLine(QByteArrayView line);
+
+    // The script reported the phase finished: move to its end
+    bool completePhase();
+
+    double percent() const { return estimate; }
+    int milestone() const { return phaseStart; }
+    int stepsDone() const { return done; }
+    int stepsTotal() const { return total; }
+
+    // "[1234/5678] ..." from ninja, or "[ 45%] ..." from make (as done of 100)
+    static bool parseCounter(QByteArrayView line, int *done, int *total);
+
+private:
+    QList<int> milestones = {100};
+    int phaseStart = 0;
+    int phaseEnd = 0;
+    int done = 0;
+    int total = 0;
+    double estimate = 0;
+};
+
+#endif // PROGRESSESTIMATOR_H
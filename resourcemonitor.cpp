@@ -0,0 +1,167 @@
+#include "resourcemonitor.h"
+
+#include <QHeaderView>
+#include <QLabel>
+#include <QPainter>
+#include <QPainterPath>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+namespace
+{
+
+QString formatBytes(double bytes)
+{
+    static const char *const units[] = {"B", "KB", "MB", "GB", "TB"};
+    int unit = 0;
+    while (bytes >= 1024 && unit < 4) {
+        bytes /= 1024;
+        ++unit;
+    }
+    return QString("%1 %2").arg(bytes, 0, 'f', unit == 0 || bytes >= 100 ? 0 : 1).arg(units[unit]);
+}
+
+QString formatCores(double cores)
+{
+    return QString("%1 cores").arg(cores, 0, 'f', 1);
+}
+
+QString formatRate(double bytesPerSecond)
+{
+    return formatBytes(bytesPerSecond) + "/s";
+}
+
+} // namespace
+
+// A caption over a filled line chart of the most recent values
+class Sparkline : public QWidget
+{
+public:
+    Sparkline(const QString &caption, QString (*format)(double), const QColor &color, QWidget *parent = nullptr)
+        : QWidget(parent)
+        , caption(caption)
+        , format(format)
+        , color(color)
+    {
+        setMinimumHeight(36);
+    }
+
+    void addValue(double value)
+    {
+        values.append(value);
+        if (values.size() > MaxValues) {
+            values.removeFirst();
+        }
+        update();
+    }
+
+    void clear()
+    {
+        values.clear();
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter painter(this);
+        painter.fillRect(rect(), QColor("#1e1e1e"));
+
+        if (values.size() >= 2) {
+            // Scaled to the largest value in view, so quiet stretches still show detail
+            const double peak = qMax(*std::max_element(values.cbegin(), values.cend()), 1e-9);
+            const double step = double(width()) / (MaxValues - 1);
+            const double left = width() - step * (values.size() - 1);
+
+            QPainterPath path(QPointF(left, height()));
+            for (int i = 0; i < int(values.size()); ++i) {
+                path.lineTo(left + step * i, height() - 1 - values.at(i) / peak * (height() - 2));
+            }
+            path.lineTo(width(), height());
+
+            painter.setRenderHint(QPainter::Antialiasing);
+            QColor fill = color;
+            fill.setAlpha(80);
+            painter.fillPath(path, fill);
+            painter.setPen(color);
+            painter.drawPath(path);
+        }
+
+        painter.setPen(QColor("#d4d4d4"));
+        const QString text = values.isEmpty() ? caption : QString("%1: %2").arg(caption, format(values.last()));
+        painter.drawText(rect().adjusted(4, 2, -4, -2), Qt::AlignLeft | Qt::AlignTop, text);
+    }
+
+private:
+    static constexpr int MaxValues = 180;   // three minutes at one sample a second
+
+    QString caption;
+    QString (*format)(double);
+    QColor color;
+    QList<double> values;
+};
+
+ResourceMonitor::ResourceMonitor(QWidget *parent)
+    : QWidget(parent)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    cpuLine = new Sparkline("CPU", formatCores, QColor("#4fc1ff"));
+    memoryLine = new Sparkline("Memory", formatBytes, QColor("#b5cea8"));
+    readLine = new Sparkline("Disk read", formatRate, QColor("#dcdcaa"));
+    writeLine = new Sparkline("Disk write", formatRate, QColor("#ce9178"));
+    for (Sparkline *line : {cpuLine, memoryLine, readLine, writeLine}) {
+        layout->addWidget(line);
+    }
+
+    layout->addWidget(new QLabel("Peaks per phase:"));
+    peakTable = new QTreeWidget();
+    peakTable->setColumnCount(ColumnCount);
+    peakTable->setHeaderLabels({"Phase", "CPU", "Memory", "Read", "Write"});
+    peakTable->setRootIsDecorated(false);
+    peakTable->setUniformRowHeights(true);
+    peakTable->header()->setStretchLastSection(false);
+    peakTable->header()->setSectionResizeMode(PhaseColumn, QHeaderView::Stretch);
+    layout->addWidget(peakTable);
+}
+
+void ResourceMonitor::addSample(const ResourceSample &sample, const QString &phase)
+{
+    cpuLine->addValue(sample.cpuCores);
+    memoryLine->addValue(double(sample.rssBytes));
+    readLine->addValue(double(sample.readBytesPerSecond));
+    writeLine->addValue(double(sample.writeBytesPerSecond));
+
+    if (!phaseItem || phase != phaseTitle) {
+        phaseTitle = phase;
+        phasePeak = ResourceSample();
+        phaseItem = new QTreeWidgetItem(peakTable, {phase});
+        phaseItem->setToolTip(PhaseColumn, phase);
+        for (int column = CpuColumn; column < ColumnCount; ++column) {
+            phaseItem->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        }
+    }
+
+    phasePeak.cpuCores = qMax(phasePeak.cpuCores, sample.cpuCores);
+    phasePeak.rssBytes = qMax(phasePeak.rssBytes, sample.rssBytes);
+    phasePeak.readBytesPerSecond = qMax(phasePeak.readBytesPerSecond, sample.readBytesPerSecond);
+    phasePeak.writeBytesPerSecond = qMax(phasePeak.writeBytesPerSecond, sample.writeBytesPerSecond);
+
+    phaseItem->setText(CpuColumn, formatCores(phasePeak.cpuCores));
+    phaseItem->setText(MemoryColumn, formatBytes(double(phasePeak.rssBytes)));
+    phaseItem->setText(ReadColumn, formatRate(double(phasePeak.readBytesPerSecond)));
+    phaseItem->setText(WriteColumn, formatRate(double(phasePeak.writeBytesPerSecond)));
+}
+
+void ResourceMonitor::clear()
+{
+    for (Sparkline *line : {cpuLine, memoryLine, readLine, writeLine}) {
+        line->clear();
+    }
+    peakTable->clear();
+    phaseItem = nullptr;
+    phaseTitle.clear();
+}
@@ -0,0 +1,39 @@
+#ifndef RESOURCEMONITOR_H
+#define RESOURCEMONITOR_H
+
+#include <QString>
+#include <QWidget>
+
+#include "resourcesampler.h"
+
+class QTreeWidget;
+class QTreeWidgetItem;
+class Sparkline;
+
+// Shows the build's resource use: one sparkline each for CPU, memory,
+// disk reads and disk writes over the last few minutes, and a table with
+// the peak of each per install phase.
+class ResourceMonitor : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ResourceMonitor(QWidget *parent = nullptr);
+
+    void addSample(const ResourceSample &sample, const QString &phase);
+    void clear();
+
+private:
+    enum Column { PhaseColumn, CpuColumn, MemoryColumn, ReadColumn, WriteColumn, ColumnCount };
+
+    Sparkline *cpuLine;
+    Sparkline *memoryLine;
+    Sparkline *readLine;
+    Sparkline *writeLine;
+    QTreeWidget *peakTable;
+    QTreeWidgetItem *phaseItem = nullptr;
+    QString phaseTitle;
+    ResourceSample phasePeak;
+};
+
+#endif // RESOURCEMONITOR_H
@@ -0,0 +1,202 @@
+#include "resourcesampler.h"
+
+#include <QTimer>
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace
+{
+
+#if defined(Q_OS_LINUX)
+
+// Reads a small /proc file into buffer, NUL-terminated; -1 if it is gone
+int readProcFile(const char *path, char *buffer, int size)
+{
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    const ssize_t count = ::read(fd, buffer, size_t(size - 1));
+    ::close(fd);
+    if (count < 0) return -1;
+    buffer[count] = '\0';
+    return int(count);
+}
+
+// utime + stime + cutime + cstime in clock ticks, and resident pages
+bool readStat(qint64 pid, qint64 *ticks, qint64 *rssPages)
+{
+    char path[64];
+    char buffer[1024];
+    std::snprintf(path, sizeof(path), "/proc/%lld/stat", static_cast<long long>(pid));
+    if (readProcFile(path, buffer, sizeof(buffer)) <= 0) return false;
+
+    // The command name may contain spaces and parentheses; fields resume after the last ')'
+    const char *cursor = std::strrchr(buffer, ')');
+    if (!cursor) return false;
+    ++cursor;
+
+    // Skip the state letter (field 3); fields 4-24 are all numbers
+    while (*cursor == ' ') ++cursor;
+    if (!*cursor) return false;
+    ++cursor;
+
+    qint64 values[21];
+    for (qint64 &value : values) {
+        char *end = nullptr;
+        value = std::strtoll(cursor, &end, 10);
+        if (end == cursor) return false;
+        cursor = end;
+    }
+
+    // utime, stime, cutime and cstime are fields 14-17, rss is field 24
+    *ticks = values[10] + values[11] + values[12] + values[13];
+    *rssPages = values[20];
+    return true;
+}
+
+void readIo(qint64 pid, qint64 *readBytes, qint64 *writeBytes)
+{
+    char path[64];
+    char buffer[512];
+    std::snprintf(path, sizeof(path), "/proc/%lld/io", static_cast<long long>(pid));
+    if (readProcFile(path, buffer, sizeof(buffer)) <= 0) return;
+
+    // Bytes that really hit storage, not rchar/wchar which count the page cache too
+    if (const char *field = std::strstr(buffer, "\nread_bytes: ")) {
+        *readBytes = std::strtoll(field + 13, nullptr, 10);
+    }
+    if (const char *field = std::strstr(buffer, "\nwrite_bytes: ")) {
+        *writeBytes = std::strtoll(field + 14, nullptr, 10);
+    }
+}
+
+// Children forked by the main thread; build tools do not fork from others
+void readChildren(qint64 pid, QList<qint64> *pending)
+{
+    char path[64];
+    char buffer[4096];
+    std::snprintf(path, sizeof(path), "/proc/%lld/task/%lld/children",
+                  static_cast<long long>(pid), static_cast<long long>(pid));
+    if (readProcFile(path, buffer, sizeof(buffer)) <= 0) return;
+
+    char *cursor = buffer;
+    for (;;) {
+        char *end = nullptr;
+        const qint64 child = std::strtoll(cursor, &end, 10);
+        if (end == cursor) break;
+        pending->append(child);
+        cursor = end;
+    }
+}
+
+#endif
+
+} // namespace
+
+ResourceSampler::ResourceSampler(QObject *parent)
+    : QObject(parent)
+    , timer(new QTimer(this))
+{
+    timer->setInterval(IntervalMs);
+    connect(timer, &QTimer::timeout, this, &ResourceSampler::sample);
+}
+
+bool ResourceSampler::isSupported()
+{
+#if defined(Q_OS_LINUX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ResourceSampler::start(qint64 pid)
+{
+    if (!isSupported()) return;
+
+    rootPid = pid;
+    processes.clear();
+    exitedReadBytes = 0;
+    exitedWriteBytes = 0;
+    lastCpuTicks = -1;
+    wallClock.start();
+    sample();
+    timer->start();
+}
+
+void ResourceSampler::stop()
+{
+    timer->stop();
+    rootPid = 0;
+}
+
+void ResourceSampler::sample()
+{
+#if defined(Q_OS_LINUX)
+    static const qint64 ticksPerSecond = ::sysconf(_SC_CLK_TCK);
+    static const qint64 pageSize = ::sysconf(_SC_PAGESIZE);
+
+    if (rootPid <= 0) return;
+
+    QHash<qint64, Process> current;
+    current.reserve(processes.size() + 16);
+    qint64 cpuTicks = 0;
+    qint64 rssPages = 0;
+    qint64 readBytes = 0;
+    qint64 writeBytes = 0;
+
+    QList<qint64> pending{rootPid};
+    while (!pending.isEmpty()) {
+        const qint64 pid = pending.takeLast();
+        qint64 ticks = 0;
+        qint64 pages = 0;
+        if (!readStat(pid, &ticks, &pages)) continue;   // exited meanwhile
+
+        Process process;
+        readIo(pid, &process.readBytes, &process.writeBytes);
+        readChildren(pid, &pending);
+
+        cpuTicks += ticks;
+        rssPages += pages;
+        readBytes += process.readBytes;
+        writeBytes += process.writeBytes;
+        current.insert(pid, process);
+    }
+
+    // Processes that are gone keep contributing what they did while we saw them
+    for (auto it = processes.constBegin(); it != processes.constEnd(); ++it) {
+        if (!current.contains(it.key())) {
+            exitedReadBytes += it->readBytes;
+            exitedWriteBytes += it->writeBytes;
+        }
+    }
+    processes = std::move(current);
+    readBytes += exitedReadBytes;
+    writeBytes += exitedWriteBytes;
+
+    const qint64 nowNs = wallClock.nsecsElapsed();
+    if (lastCpuTicks >= 0 && nowNs > lastSampleNs) {
+        const double seconds = (nowNs - lastSampleNs) / 1e9;
+
+        // An orphan reparented away takes its time with it; never report negative use
+        ResourceSample result;
+        result.cpuCores = qMax<qint64>(0, cpuTicks - lastCpuTicks) / double(ticksPerSecond) / seconds;
+        result.rssBytes = rssPages * pageSize;
+        result.readBytesPerSecond = qint64(qMax<qint64>(0, readBytes - lastReadBytes) / seconds);
+        result.writeBytesPerSecond = qint64(qMax<qint64>(0, writeBytes - lastWriteBytes) / seconds);
+        result.processCount = int(processes.size());
+        emit sampled(result);
+    }
+
+    lastCpuTicks = cpuTicks;
+    lastReadBytes = readBytes;
+    lastWriteBytes = writeBytes;
+    lastSampleNs = nowNs;
+#endif
+}
@@ -0,0 +1,69 @@
+#ifndef RESOURCESAMPLER_H
+#define RESOURCESAMPLER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+
+class QTimer;
+
+// One reading of the whole build process tree
+struct ResourceSample
+{
+    double cpuCores = 0;            // CPU time used per second of wall time
+    qint64 rssBytes = 0;
+    qint64 readBytesPerSecond = 0;
+    qint64 writeBytesPerSecond = 0;
+    int processCount = 0;
+};
+
+// Samples CPU, memory and disk I/O of a process and all its descendants.
+//
+// Linux only: every interval the tree is walked from the root through each
+// process's /proc/<pid>/task/<pid>/children, so only the build's own
+// processes are read, never all of /proc. CPU time includes the children
+// each process has already reaped (cutime and cstime), so short-lived
+// compilers are counted even if no sample ever saw them. I/O has no such
+// total; the last values read from a process are kept once it is gone.
+// Lives on the worker thread.
+class ResourceSampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ResourceSampler(QObject *parent = nullptr);
+
+    static bool isSupported();
+
+public slots:
+    void start(qint64 rootPid);
+    void stop();
+
+signals:
+    void sampled(const ResourceSample &sample);
+
+private slots:
+    void sample();
+
+private:
+    struct Process
+    {
+        qint64 readBytes = 0;
+        qint64 writeBytes = 0;
+    };
+
+    static constexpr int IntervalMs = 1000;
+
+    QTimer *timer;
+    QElapsedTimer wallClock;
+    QHash<qint64, Process> processes;   // as of the last sample
+    qint64 rootPid = 0;
+    qint64 exitedReadBytes = 0;
+    qint64 exitedWriteBytes = 0;
+    qint64 lastCpuTicks = -1;
+    qint64 lastReadBytes = 0;
+    qint64 lastWriteBytes = 0;
+    qint64 lastSampleNs = 0;
+};
+
+#endif // RESOURCESAMPLER_H
@@ -0,0 +1,100 @@
+#ifndef SESSIONCLOCK_H
+#define SESSIONCLOCK_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <atomic>
+
+#include "logline.h"
+
+// Shared time base and sequence counter for one installation run.
+//
+// Every line, whether read from the script or written by the installer
+// itself, takes its sequence number from here, so stdout, stderr and our own
+// messages form one ordered stream. Timestamps are microseconds on a
+// monotonic clock since restart(). The timer itself is never restarted;
+// restart() and follow() only move the atomic origin, so they may run on
+// one thread while another is stamping lines.
+class SessionClock
+{
+public:
+    SessionClock() { timer.start(); }
+
+    void restart()
+    {
+        originUs.store(nowUs(), std::memory_order_relaxed);
+        nextSequence.store(0, std::memory_order_relaxed);
+    }
+
+    // Continues a clock that another process started elapsedUs ago
+    void follow(qint64 elapsedUs)
+    {
+        originUs.store(nowUs() - elapsedUs, std::memory_order_relaxed);
+    }
+
+    qint64 elapsedUs() const { return nowUs() - originUs.load(std::memory_order_relaxed); }
+
+    // Stamps a line that arrived at timestampUs, as returned by elapsedUs()
+    void stamp(LogLine *line, qint64 timestampUs)
+    {
+        line->sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+        line->timestampUs = timestampUs;
+    }
+
+    // "hh:mm:ss.mmm"; buffer must hold ElapsedTextSize characters
+    static constexpr int ElapsedTextSize = 12;
+    static void formatElapsed(qint64 us, char *buffer)
+    {
+        const qint64 ms = us / 1000;
+        const int fields[] = {int(qMin<qint64>(ms / 3600000, 99)), int(ms / 60000 % 60), int(ms / 1000 % 60)};
+        for (int i = 0; i < 3; ++i) {
+            buffer[i * 3] = char('0' + fields[i] / 10);
+            buffer[i * 3 + 1] = char('0' + fields[i] % 10);
+            buffer[i * 3 + 2] = i < 2 ? ':' : '.';
+        }
+        const int millis = int(ms % 1000);
+        buffer[9] = char('0' + millis / 100);
+        buffer[10] = char('0' + millis / 10 % 10);
+        buffer[11] = char('0' + millis % 10);
+    }
+
+    // Reads back what formatElapsed() wrote
+    static bool parseElapsed(const char *buffer, qint64 *us)
+    {
+        for (int i = 0; i < ElapsedTextSize; ++i) {
+            const char c = buffer[i];
+            if (i == 2 || i == 5) {
+                if (c != ':') return false;
+            } else if (i == 8) {
+                if (c != '.') return false;
+            } else if (c < '0' || c > '9') {
+                return false;
+            }
+        }
+        auto field = [buffer](int at, int digits) {
+            int number = 0;
+            for (int i = 0; i < digits; ++i) number = number * 10 + (buffer[at + i] - '0');
+            return number;
+        };
+        const qint64 ms = ((field(0, 2) * 60LL + field(3, 2)) * 60 + field(6, 2)) * 1000 + field(9, 3);
+        *us = ms * 1000;
+        return true;
+    }
+
+    static QString formatElapsed(qint64 us)
+    {
+        char buffer[ElapsedTextSize];
+        formatElapsed(us, buffer);
+        return QString::fromLatin1(buffer, ElapsedTextSize);
+    }
+
+private:
+    qint64 nowUs() const { return timer.nsecsElapsed() / 1000; }
+
+    QElapsedTimer timer;
+    std::atomic<qint64> originUs{0};
+    std::atomic<quint64> nextSequence{0};
+};
+
+#endif // SESSIONCLOCK_H
@@ -0,0 +1,70 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer and one consumer thread.
+//
+// Capacity is rounded up to a power of two. The producer only writes tail
+// and the consumer only writes head, each on its own cache line, so the
+// two sides never contend on the same atomic.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(std::size_t capacity)
+        : slots(roundUp(capacity))
+        , mask(slots.size() - 1)
+    {
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // Producer side; returns false and leaves value untouched when full
+    bool tryPush(T &&value)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == slots.size()) return false;
+
+        slots[t & mask] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; returns false when empty
+    bool tryPop(T &value)
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+
+        value = std::move(slots[h & mask]);
+        slots[h & mask] = T();
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static std::size_t roundUp(std::size_t n)
+    {
+        std::size_t size = 2;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    std::vector<T> slots;
+    const std::size_t mask;
+
+    alignas(64) std::atomic<std::size_t> head{0};   // next slot to pop
+    alignas(64) std::atomic<std::size_t> tail{0};   // next slot to push
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,158 @@
+#include <QtTest>
+
+#include "ansiparser.h"
+
+class AnsiParserTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void leavesPlainLinesAlone();
+    void turnsSgrIntoSpans_data();
+    void turnsSgrIntoSpans();
+    void carriesStyleAcrossLines();
+    void stripsOtherEscapes_data();
+    void stripsOtherEscapes();
+    void mapsPaletteIndexes();
+};
+
+namespace
+{
+
+constexpr quint32 Red = AnsiParser::HasColor | 0xcd3131;
+constexpr quint32 Green = AnsiParser::HasColor | 0x0dbc79;
+
+// "start+length:style" per span, which QCOMPARE can print
+QStringList describe(const StyleSpans &spans)
+{
+    QStringList result;
+    for (const StyleSpan &span : spans) {
+        result.append(QString("%1+%2:%3").arg(span.start).arg(span.length).arg(span.style, 0, 16));
+    }
+    return result;
+}
+
+QStringList describe(std::initializer_list<StyleSpan> spans)
+{
+    return describe(StyleSpans(spans));
+}
+
+} // namespace
+
+void AnsiParserTest::leavesPlainLinesAlone()
+{
+    AnsiParser parser;
+    QByteArray text;
+    StyleSpans spans;
+    QVERIFY(!parser.process("[12/345] Building CXX object\twith a tab", &text, &spans));
+    QVERIFY(!parser.process("", &text, &spans));
+}
+
+void AnsiParserTest::turnsSgrIntoSpans_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<QByteArray>("text");
+    QTest::addColumn<QStringList>("spans");
+
+    QTest::newRow("color then reset") << QByteArray("\x1b[31mred\x1b[0m plain") << QByteArray("red plain")
+                                      << describe({{0, 3, Red}});
+    QTest::newRow("empty parameters reset") << QByteArray("\x1b[32mgo\x1b[m on") << QByteArray("go on")
+                                            << describe({{0, 2, Green}});
+    QTest::newRow("bold and underline") << QByteArray("\x1b[1;4mBU\x1b[22mU\x1b[0m")
+                                        << QByteArray("BUU")
+                                        << describe({{0, 2, AnsiParser::Bold | AnsiParser::Underline},
+                                                     {2, 1, AnsiParser::Underline}});
+    QTest::newRow("256 colors") << QByteArray("\x1b[38;5;196mX\x1b[0m") << QByteArray("X")
+                                << describe({{0, 1, AnsiParser::HasColor | 0xff0000}});
+    QTest::newRow("true color") << QByteArray("\x1b[38;2;1;2;3mX\x1b[39m") << QByteArray("X")
+                                << describe({{0, 1, AnsiParser::HasColor | 0x010203}});
+    QTest::newRow("background is skipped") << QByteArray("\x1b[48;5;21mX\x1b[0m") << QByteArray("X")
+                                           << QStringList();
+    QTest::newRow("clang warning") << QByteArray("\x1b[1ma.cpp:1:2: \x1b[0;1;35mwarning: \x1b[0mtext")
+                                   << QByteArray("a.cpp:1:2: warning: text")
+                                   << describe({{0, 11, AnsiParser::Bold},
+                                                {11, 9, AnsiParser::Bold | AnsiParser::HasColor | 0xbc3fbc}});
+}
+
+void AnsiParserTest::turnsSgrIntoSpans()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(QByteArray, text);
+    QFETCH(QStringList, spans);
+
+    AnsiParser parser;
+    QByteArray stripped;
+    StyleSpans styled;
+    QVERIFY(parser.process(line, &stripped, &styled));
+    QCOMPARE(stripped, text);
+    QCOMPARE(describe(styled), spans);
+}
+
+void AnsiParserTest::carriesStyleAcrossLines()
+{
+    AnsiParser parser;
+    QByteArray text;
+    StyleSpans spans;
+
+    QVERIFY(parser.process("\x1b[32mstart", &text, &spans));
+    const QStringList started = describe({{0, 5, Green}});
+    QCOMPARE(describe(spans), started);
+
+    // No escapes, but the color is still on
+    QVERIFY(parser.process("continued", &text, &spans));
+    QCOMPARE(text, QByteArray("continued"));
+    const QStringList continued = describe({{0, 9, Green}});
+    QCOMPARE(describe(spans), continued);
+
+    QVERIFY(parser.process("\x1b[0mdone", &text, &spans));
+    QCOMPARE(text, QByteArray("done"));
+    QVERIFY(spans.isEmpty());
+    QVERIFY(!parser.process("after", &text, &spans));
+
+    // A new run starts from the default style
+    QVERIFY(parser.process("\x1b[1mbold", &text, &spans));
+    parser.reset();
+    QVERIFY(!parser.process("plain", &text, &spans));
+}
+
+void AnsiParserTest::stripsOtherEscapes_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<QByteArray>("text");
+
+    QTest::newRow("erase line") << QByteArray("a\x1b[2Kb") << QByteArray("ab");
+    QTest::newRow("osc with bel") << QByteArray("a\x1b]0;title\x07" "b") << QByteArray("ab");
+    QTest::newRow("osc hyperlink") << QByteArray("\x1b]8;;http://qt.io\x1b\\link\x1b]8;;\x1b\\")
+                                   << QByteArray("link");
+    QTest::newRow("two-byte escape") << QByteArray("a\x1bMb") << QByteArray("ab");
+    QTest::newRow("c0 controls") << QByteArray("a\x01" "b\x7f" "c\td") << QByteArray("abc\td");
+    QTest::newRow("escape at the end") << QByteArray("ab\x1b") << QByteArray("ab");
+}
+
+void AnsiParserTest::stripsOtherEscapes()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(QByteArray, text);
+
+    AnsiParser parser;
+    QByteArray stripped;
+    StyleSpans spans;
+    QVERIFY(parser.process(line, &stripped, &spans));
+    QCOMPARE(stripped, text);
+    QVERIFY(spans.isEmpty());
+}
+
+void AnsiParserTest::mapsPaletteIndexes()
+{
+    QCOMPARE(AnsiParser::rgbForIndex(1), quint32(0xcd3131));
+    QCOMPARE(AnsiParser::rgbForIndex(15), quint32(0xffffff));
+    QCOMPARE(AnsiParser::rgbForIndex(16), quint32(0x000000));
+    QCOMPARE(AnsiParser::rgbForIndex(21), quint32(0x0000ff));
+    QCOMPARE(AnsiParser::rgbForIndex(232), quint32(0x080808));
+    QCOMPARE(AnsiParser::rgbForIndex(255), quint32(0xeeeeee));
+    QCOMPARE(AnsiParser::rgbForIndex(300), quint32(0xe5e5e5));
+}
+
+QTEST_APPLESS_MAIN(AnsiParserTest)
+
+#include "tst_ansiparser.moc"
@@ -0,0 +1,124 @@
+#include <QtTest>
+
+#include "diagnosticparser.h"
+
+Q_DECLARE_METATYPE(Diagnostic::Severity)
+
+class DiagnosticParserTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parses_data();
+    void parses();
+    void rejects_data();
+    void rejects();
+    void internsDuplicates();
+};
+
+void DiagnosticParserTest::parses_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<Diagnostic::Severity>("severity");
+    QTest::addColumn<QByteArray>("file");
+    QTest::addColumn<int>("lineNumber");
+    QTest::addColumn<int>("column");
+    QTest::addColumn<QByteArray>("message");
+    QTest::addColumn<QByteArray>("flag");
+
+    const auto Warning = Diagnostic::Severity::Warning;
+    const auto Error = Diagnostic::Severity::Error;
+
+    QTest::newRow("clang warning")
+        << QByteArray("/src/qt6/qfile.cpp:12:5: warning: unused variable 'x' [-Wunused-variable]")
+        << Warning << QByteArray("/src/qt6/qfile.cpp") << 12 << 5
+        << QByteArray("unused variable 'x'") << QByteArray("-Wunused-variable");
+    QTest::newRow("flag promoted to error")
+        << QByteArray("a.cpp:1:2: error: shadows [-Wshadow,-Werror]")
+        << Error << QByteArray("a.cpp") << 1 << 2 << QByteArray("shadows") << QByteArray("-Wshadow");
+    QTest::newRow("no column")
+        << QByteArray("a.cpp:3: error: expected ';'")
+        << Error << QByteArray("a.cpp") << 3 << 0 << QByteArray("expected ';'") << QByteArray();
+    QTest::newRow("fatal error")
+        << QByteArray("  b.h:7:10: fatal error: 'c.h' file not found")
+        << Error << QByteArray("b.h") << 7 << 10 << QByteArray("'c.h' file not found") << QByteArray();
+    QTest::newRow("tool without location")
+        << QByteArray("clang++: error: linker command failed with exit code 1")
+        << Error << QByteArray("clang++") << 0 << 0
+        << QByteArray("linker command failed with exit code 1") << QByteArray();
+    QTest::newRow("windows drive letter")
+        << QByteArray("C:/qt/a.cpp:4:1: warning: x")
+        << Warning << QByteArray("C:/qt/a.cpp") << 4 << 1 << QByteArray("x") << QByteArray();
+    QTest::newRow("cmake dev warning")
+        << QByteArray("CMake Warning (dev) at CMakeLists.txt:10 (find_package):")
+        << Warning << QByteArray("CMakeLists.txt") << 10 << 0
+        << QByteArray("(find_package)") << QByteArray("-Wdev");
+    QTest::newRow("cmake deprecation")
+        << QByteArray("CMake Deprecation Warning at cmake/Qt.cmake:3 (cmake_policy):")
+        << Warning << QByteArray("cmake/Qt.cmake") << 3 << 0
+        << QByteArray("(cmake_policy)") << QByteArray("-Wdeprecated");
+    QTest::newRow("cmake error without location")
+        << QByteArray("CMake Error: The source directory does not exist.")
+        << Error << QByteArray("CMake") << 0 << 0
+        << QByteArray("The source directory does not exist.") << QByteArray();
+}
+
+void DiagnosticParserTest::parses()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(Diagnostic::Severity, severity);
+    QFETCH(QByteArray, file);
+    QFETCH(int, lineNumber);
+    QFETCH(int, column);
+    QFETCH(QByteArray, message);
+    QFETCH(QByteArray, flag);
+
+    Diagnostic diagnostic;
+    QVERIFY(DiagnosticParser::parse(line, &diagnostic));
+    QCOMPARE(diagnostic.severity, severity);
+    QCOMPARE(diagnostic.file, file);
+    QCOMPARE(diagnostic.line, lineNumber);
+    QCOMPARE(diagnostic.column, column);
+    QCOMPARE(diagnostic.message, message);
+    QCOMPARE(diagnostic.flag, flag);
+}
+
+void DiagnosticParserTest::rejects_data()
+{
+    QTest::addColumn<QByteArray>("line");
+
+    QTest::newRow("empty") << QByteArray("   ");
+    QTest::newRow("plain") << QByteArray("[12/345] Building CXX object a.o");
+    QTest::newRow("prose before the severity") << QByteArray("Note that this is a warning: maybe");
+    QTest::newRow("include trace") << QByteArray("In file included from a.h:1:");
+    QTest::newRow("cmake status") << QByteArray("CMake Generate step done");
+}
+
+void DiagnosticParserTest::rejects()
+{
+    QFETCH(QByteArray, line);
+
+    Diagnostic diagnostic;
+    QVERIFY(!DiagnosticParser::parse(line, &diagnostic));
+}
+
+void DiagnosticParserTest::internsDuplicates()
+{
+    DiagnosticParser parser;
+    const QByteArray first("a.cpp:1:2: warning: x [-Wx]");
+    const QByteArray second("a.cpp:9:2: warning: x [-Wx]");
+
+    QCOMPARE(parser.intern(first), 0);
+    QCOMPARE(parser.intern(second), 1);
+    QCOMPARE(parser.intern(first), 0);
+    QCOMPARE(parser.intern("no diagnostic here"), -1);
+    QCOMPARE(parser.count(), 2);
+
+    parser.clear();
+    QCOMPARE(parser.count(), 0);
+    QCOMPARE(parser.intern(second), 0);
+}
+
+QTEST_APPLESS_MAIN(DiagnosticParserTest)
+
+#include "tst_diagnosticparser.moc"
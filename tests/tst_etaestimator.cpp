@@ -0,0 +1,155 @@
+#include <QtTest>
+
+#include "etaestimator.h"
+#include "phasehistory.h"
+
+class EtaEstimatorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void formatsDurations_data();
+    void formatsDurations();
+    void needsHistoryOrCounters();
+    void predictsFromHistory();
+    void blendsInLiveRate();
+    void freezesWhilePaused();
+    void recordsFinishedPhases();
+
+private:
+    static constexpr qint64 Second = 1000 * 1000;
+    static LogLine milestone(int progress, const char *title, qint64 timestampUs);
+};
+
+namespace
+{
+
+const PhaseHistory::Traits RunTraits{8, 4, false};
+
+} // namespace
+
+LogLine EtaEstimatorTest::milestone(int progress, const char *title, qint64 timestampUs)
+{
+    LogLine line{QByteArray(title), LineClass::Info};
+    line.progress = progress;
+    line.timestampUs = timestampUs;
+    return line;
+}
+
+void EtaEstimatorTest::formatsDurations_data()
+{
+    QTest::addColumn<double>("seconds");
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("seconds") << 40.0 << QString("40s");
+    QTest::newRow("rounds up to a minute") << 59.6 << QString("1m");
+    QTest::newRow("minutes") << 720.0 << QString("12m");
+    QTest::newRow("nearest minute") << 750.0 << QString("13m");
+    QTest::newRow("hours") << 3900.0 << QString("1h 05m");
+}
+
+void EtaEstimatorTest::formatsDurations()
+{
+    QFETCH(double, seconds);
+    QFETCH(QString, text);
+    QCOMPARE(EtaEstimator::formatDuration(seconds), text);
+}
+
+void EtaEstimatorTest::needsHistoryOrCounters()
+{
+    PhaseHistory history;
+    EtaEstimator eta;
+    QCOMPARE(eta.phaseRemaining(history, 0), -1.0);
+
+    eta.start(RunTraits);
+    eta.addLines({milestone(30, "Building Qt6 host", 10 * Second)});
+    QCOMPARE(eta.phaseRemaining(history, 20 * Second), -1.0);
+    QCOMPARE(eta.totalRemaining(history, 20 * Second), -1.0);
+
+    // Live counters alone are enough once a few steps are done
+    eta.setSteps(25, 100);
+    QCOMPARE(eta.phaseRemaining(history, 20 * Second), 30.0);
+}
+
+void EtaEstimatorTest::predictsFromHistory()
+{
+    PhaseHistory history;
+    history.record(30, "Building Qt6 host", 600, 0, RunTraits);
+    history.record(50, "Installing Qt6 host", 60, 0, RunTraits);
+
+    EtaEstimator eta;
+    eta.start(RunTraits);
+    eta.addLines({milestone(30, "Building Qt6 host", 10 * Second)});
+
+    QCOMPARE(eta.phaseRemaining(history, 110 * Second), 500.0);
+    QCOMPARE(eta.totalRemaining(history, 110 * Second), 560.0);
+
+    // Running late: "about done", not a negative time
+    QCOMPARE(eta.phaseRemaining(history, 900 * Second), 0.0);
+}
+
+void EtaEstimatorTest::blendsInLiveRate()
+{
+    PhaseHistory history;
+    history.record(30, "Building Qt6 host", 600, 0, RunTraits);
+
+    EtaEstimator eta;
+    eta.start(RunTraits);
+    eta.addLines({milestone(30, "Building Qt6 host", 10 * Second)});
+
+    // Half done after 100 s: live says 200 s in all, history 600 s, weighted by progress
+    eta.setSteps(50, 100);
+    QCOMPARE(eta.phaseRemaining(history, 110 * Second), 300.0);
+
+    // Too few steps for the live rate to count
+    eta.setSteps(1, 100);
+    QCOMPARE(eta.phaseRemaining(history, 110 * Second), 500.0);
+}
+
+void EtaEstimatorTest::freezesWhilePaused()
+{
+    PhaseHistory history;
+    history.record(30, "Building Qt6 host", 600, 0, RunTraits);
+
+    EtaEstimator eta;
+    eta.start(RunTraits);
+    eta.addLines({milestone(30, "Building Qt6 host", 10 * Second)});
+
+    eta.pause(110 * Second);
+    QVERIFY(eta.isPaused());
+    QCOMPARE(eta.phaseRemaining(history, 400 * Second), 500.0);
+
+    eta.resume(200 * Second);
+    QVERIFY(!eta.isPaused());
+    QCOMPARE(eta.totalPausedUs(), 90 * Second);
+    QCOMPARE(eta.phaseRemaining(history, 200 * Second), 500.0);
+}
+
+void EtaEstimatorTest::recordsFinishedPhases()
+{
+    PhaseHistory history;
+    EtaEstimator eta;
+    eta.start(RunTraits);
+    eta.addLines({milestone(30, "Building Qt6 host", 10 * Second),
+                  milestone(20, "Not a new phase", 20 * Second)});
+    eta.pause(100 * Second);
+    eta.resume(190 * Second);
+    eta.finish(true, 710 * Second, &history);
+
+    // Startup ran 10 s; the host build 700 s, of which 90 s paused
+    QCOMPARE(history.predict(0, RunTraits), 10.0);
+    QCOMPARE(history.predict(30, RunTraits), 610.0);
+    QCOMPARE(history.predict(20, RunTraits), -1.0);
+
+    // A failed run keeps only the phases it got through
+    PhaseHistory failed;
+    eta.start(RunTraits);
+    eta.addLines({milestone(30, "Building Qt6 host", 10 * Second)});
+    eta.finish(false, 50 * Second, &failed);
+    QCOMPARE(failed.predict(0, RunTraits), 10.0);
+    QCOMPARE(failed.predict(30, RunTraits), -1.0);
+}
+
+QTEST_APPLESS_MAIN(EtaEstimatorTest)
+
+#include "tst_etaestimator.moc"
@@ -0,0 +1,152 @@
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <string>
+
+#include "keywordautomaton.h"
+#include "lineclassifier.h"
+
+Q_DECLARE_METATYPE(LineClass)
+
+class LineClassifierTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void automatonMatchesOverlappingKeywords();
+    void automatonRejectsEmptyAndExtraKeywords();
+    void classifies_data();
+    void classifies();
+    void customRulesComeFirst();
+    void rejectsMalformedRules();
+    void ignoresMissingRulesFile();
+};
+
+namespace
+{
+
+quint64 match(const KeywordAutomaton &automaton, const std::string &text)
+{
+    return automaton.match(text.data(), text.size());
+}
+
+} // namespace
+
+void LineClassifierTest::automatonMatchesOverlappingKeywords()
+{
+    KeywordAutomaton automaton;
+    QCOMPARE(automaton.addKeyword("he"), 0);
+    QCOMPARE(automaton.addKeyword("she"), 1);
+    QCOMPARE(automaton.addKeyword("his"), 2);
+    QCOMPARE(automaton.addKeyword("hers"), 3);
+    automaton.build();
+
+    // "she" and "hers" overlap "he", reached through suffix links
+    QCOMPARE(match(automaton, "ushers"), quint64(0b1011));
+    QCOMPARE(match(automaton, "ahishers"), quint64(0b1111));
+    QCOMPARE(match(automaton, ""), quint64(0));
+    QCOMPARE(match(automaton, "HIS"), quint64(0));
+}
+
+void LineClassifierTest::automatonRejectsEmptyAndExtraKeywords()
+{
+    KeywordAutomaton automaton;
+    QCOMPARE(automaton.addKeyword(""), -1);
+    for (int i = 0; i < KeywordAutomaton::MaxKeywords; ++i) {
+        QCOMPARE(automaton.addKeyword("k" + std::to_string(i) + ";"), i);
+    }
+    QCOMPARE(automaton.addKeyword("one too many"), -1);
+    automaton.build();
+
+    QCOMPARE(match(automaton, "k63;"), quint64(1) << 63);
+    QCOMPARE(match(automaton, "k0;k1;"), quint64(0b11));
+}
+
+void LineClassifierTest::classifies_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<LineClass>("lineClass");
+    QTest::addColumn<int>("progress");
+    QTest::addColumn<bool>("maybeDiagnostic");
+
+    QTest::newRow("plain") << QByteArray("-- Looking for pthread.h") << LineClass::Plain << -1 << false;
+    QTest::newRow("info tag") << QByteArray("[INFO] Downloading Qt6") << LineClass::Info << -1 << false;
+    QTest::newRow("first color rule wins") << QByteArray("[INFO] Configuring failed with Error")
+                                           << LineClass::Info << -1 << false;
+    QTest::newRow("milestone") << QByteArray("[INFO] Building Qt6 host (this will take 1-2 hours)...")
+                               << LineClass::Info << 30 << false;
+    QTest::newRow("section") << QByteArray("=== Installation Complete ===") << LineClass::Success << 100 << false;
+    QTest::newRow("compiler error") << QByteArray("qfile.cpp:12:5: error: expected ';'")
+                                    << LineClass::Error << -1 << true;
+    QTest::newRow("compiler warning") << QByteArray("qfile.cpp:12:5: warning: unused variable 'x'")
+                                      << LineClass::Plain << -1 << true;
+    QTest::newRow("cmake warning") << QByteArray("CMake Warning (dev) at CMakeLists.txt:10 (project):")
+                                   << LineClass::Plain << -1 << true;
+    QTest::newRow("case matters") << QByteArray("building in lower case") << LineClass::Plain << -1 << false;
+}
+
+void LineClassifierTest::classifies()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(LineClass, lineClass);
+    QFETCH(int, progress);
+    QFETCH(bool, maybeDiagnostic);
+
+    const LineClassifier classifier;
+    const LineClassifier::Result result = classifier.classify(line);
+    QCOMPARE(result.lineClass, lineClass);
+    QCOMPARE(result.progress, progress);
+    QCOMPARE(result.maybeDiagnostic, maybeDiagnostic);
+}
+
+void LineClassifierTest::customRulesComeFirst()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile file(dir.filePath("rules.conf"));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("# comment\n\ncolor warning deprecated since\nprogress 42 Generating docs\n");
+    file.close();
+
+    LineClassifier classifier;
+    QString errorString;
+    QVERIFY2(classifier.loadRules(file.fileName(), &errorString), qPrintable(errorString));
+
+    QCOMPARE(classifier.classify("Building: deprecated since 6.5").lineClass, LineClass::Warning);
+    QCOMPARE(classifier.classify("Generating docs").progress, 42);
+    QCOMPARE(classifier.milestones().first(), 42);
+    QVERIFY(classifier.milestones().contains(100));
+
+    // The built-in rules still apply behind the custom ones
+    QCOMPARE(classifier.classify("[ERROR] failed").lineClass, LineClass::Error);
+}
+
+void LineClassifierTest::rejectsMalformedRules()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile file(dir.filePath("rules.conf"));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("color purple something\n");
+    file.close();
+
+    LineClassifier classifier;
+    QString errorString;
+    QVERIFY(!classifier.loadRules(file.fileName(), &errorString));
+    QVERIFY(errorString.contains(":1:"));
+
+    // The table is left as it was
+    QCOMPARE(classifier.classify("[WARNING] low disk space").lineClass, LineClass::Warning);
+}
+
+void LineClassifierTest::ignoresMissingRulesFile()
+{
+    QTemporaryDir dir;
+    LineClassifier classifier;
+    QVERIFY(classifier.loadRules(dir.filePath("missing.conf")));
+    QCOMPARE(classifier.classify("[SUCCESS] done").lineClass, LineClass::Success);
+}
+
+QTEST_APPLESS_MAIN(LineClassifierTest)
+
+#include "tst_lineclassifier.moc"
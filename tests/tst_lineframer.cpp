@@ -0,0 +1,119 @@
+#include <QtTest>
+
+#include "lineframer.h"
+
+class LineFramerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void framesLines_data();
+    void framesLines();
+    void carriesPartialLines();
+    void splitsCrLfAcrossReads();
+    void cutsEndlessLines();
+    void resetDropsPartialLine();
+    void decodesUtf8();
+
+private:
+    static QList<QByteArray> feedAll(LineFramer *framer, const QList<QByteArray> &reads);
+};
+
+QList<QByteArray> LineFramerTest::feedAll(LineFramer *framer, const QList<QByteArray> &reads)
+{
+    QList<QByteArray> lines;
+    auto sink = [&lines](QByteArrayView line) { lines.append(line.toByteArray()); };
+    for (const QByteArray &read : reads) {
+        framer->feed(read, sink);
+    }
+    framer->finish(sink);
+    return lines;
+}
+
+void LineFramerTest::framesLines_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<QList<QByteArray>>("expected");
+
+    QTest::newRow("lf") << QByteArray("one\ntwo\n") << QList<QByteArray>{"one", "two"};
+    QTest::newRow("crlf") << QByteArray("one\r\ntwo\r\n") << QList<QByteArray>{"one", "two"};
+    QTest::newRow("empty lines") << QByteArray("\n\r\n\n") << QList<QByteArray>{"", "", ""};
+    QTest::newRow("bare cr keeps the last rewrite") << QByteArray("10%\r50%\r100%\n") << QList<QByteArray>{"100%"};
+    QTest::newRow("bare cr before crlf") << QByteArray("a\rb\r\n") << QList<QByteArray>{"b"};
+    QTest::newRow("unterminated tail") << QByteArray("one\ntail") << QList<QByteArray>{"one", "tail"};
+}
+
+void LineFramerTest::framesLines()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(QList<QByteArray>, expected);
+
+    LineFramer whole;
+    QCOMPARE(feedAll(&whole, {input}), expected);
+
+    // Every possible split between two reads gives the same lines
+    for (qsizetype split = 1; split < input.size(); ++split) {
+        LineFramer framer;
+        QCOMPARE(feedAll(&framer, {input.left(split), input.mid(split)}), expected);
+    }
+}
+
+void LineFramerTest::carriesPartialLines()
+{
+    LineFramer framer;
+    QList<QByteArray> lines;
+    auto sink = [&lines](QByteArrayView line) { lines.append(line.toByteArray()); };
+
+    framer.feed("[1/3] Buil", sink);
+    QVERIFY(lines.isEmpty());
+    framer.feed("ding a\n[2/3] Buil", sink);
+    QCOMPARE(lines, QList<QByteArray>{"[1/3] Building a"});
+    framer.feed("ding b\n", sink);
+    QCOMPARE(lines, (QList<QByteArray>{"[1/3] Building a", "[2/3] Building b"}));
+
+    // Nothing is left over once a read ends in a newline
+    framer.finish(sink);
+    QCOMPARE(lines.size(), qsizetype(2));
+}
+
+void LineFramerTest::splitsCrLfAcrossReads()
+{
+    LineFramer framer;
+    QCOMPARE(feedAll(&framer, {"first\r", "\nsecond\r", "\n"}), (QList<QByteArray>{"first", "second"}));
+}
+
+void LineFramerTest::cutsEndlessLines()
+{
+    LineFramer framer;
+    const QByteArray chunk(LineFramer::MaxLineLength / 4, 'x');
+    QList<QByteArray> lines = feedAll(&framer, {chunk, chunk, chunk, chunk, "end\n"});
+
+    QCOMPARE(lines.size(), qsizetype(2));
+    QCOMPARE(lines.first().size(), LineFramer::MaxLineLength);
+    QCOMPARE(lines.last(), QByteArray("end"));
+}
+
+void LineFramerTest::resetDropsPartialLine()
+{
+    LineFramer framer;
+    QList<QByteArray> lines;
+    auto sink = [&lines](QByteArrayView line) { lines.append(line.toByteArray()); };
+
+    framer.feed("stale", sink);
+    framer.reset();
+    framer.feed("fresh\n", sink);
+    framer.finish(sink);
+    QCOMPARE(lines, QList<QByteArray>{"fresh"});
+}
+
+void LineFramerTest::decodesUtf8()
+{
+    LineFramer framer;
+    const QByteArray line = QString::fromUtf8("Größe: 3 µs").toUtf8();
+    QCOMPARE(framer.decode(line).toString(), QString::fromUtf8("Größe: 3 µs"));
+    QCOMPARE(framer.decode("plain").toString(), QString("plain"));
+}
+
+QTEST_APPLESS_MAIN(LineFramerTest)
+
+#include "tst_lineframer.moc"
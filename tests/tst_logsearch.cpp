@@ -0,0 +1,194 @@
+#include <QSignalSpy>
+#include <QtTest>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "logsearch.h"
+#include "logstore.h"
+#include "trigramindex.h"
+
+class LogSearchTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void indexNarrowsToBlocks();
+    void requiredLiterals_data();
+    void requiredLiterals();
+    void findsRankedHits();
+    void regexUsesLiterals();
+    void rejectsInvalidRegex();
+    void cancelDropsResults();
+
+private:
+    static constexpr qsizetype SmallChunk = 512;
+    static constexpr int LineCount = 3000;
+
+    static void fill(LogStore *store);
+};
+
+namespace
+{
+
+std::vector<std::uint32_t> candidates(const std::vector<std::uint32_t> &entries, const std::string &literal)
+{
+    std::vector<std::uint32_t> blocks;
+    TrigramIndex::candidateBlocks(entries.data(), entries.size(), TrigramIndex::queryKeys({literal}), &blocks);
+    return blocks;
+}
+
+} // namespace
+
+void LogSearchTest::fill(LogStore *store)
+{
+    for (int i = 0; i < LineCount; ++i) {
+        LogLine line{"line " + QByteArray::number(i) + " of the build"};
+        if (i == 100) {
+            line = {"error: undefined reference to `foo'", LineClass::Error};
+        } else if (i == 2500) {
+            line = {"warning: undefined reference tracking", LineClass::Warning};
+        } else if (i == LineCount - 1) {
+            line = {"undefined reference at the end"};
+        }
+        store->append(line);
+    }
+}
+
+void LogSearchTest::indexNarrowsToBlocks()
+{
+    TrigramIndex index;
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        const std::string line = i == 70 ? "linker error: undefined reference to 'main'"
+                                         : "[" + std::to_string(i) + "/100] Building CXX object";
+        index.addLine(i, line.data(), line.size());
+    }
+    const std::vector<std::uint32_t> entries = index.take();
+    QVERIFY(std::is_sorted(entries.cbegin(), entries.cend()));
+    QVERIFY(index.take().empty());
+
+    // Line 70 is in the third block of 32; case does not matter
+    QCOMPARE(candidates(entries, "UNDEFINED reference"), std::vector<std::uint32_t>{2});
+    QCOMPARE(candidates(entries, "building"), (std::vector<std::uint32_t>{0, 1, 2, 3}));
+    QVERIFY(candidates(entries, "zzyzx").empty());
+
+    // Every literal must be present in the same block
+    QCOMPARE(TrigramIndex::queryKeys({"link", "main"}).size(), std::size_t(4));
+    std::vector<std::uint32_t> blocks;
+    TrigramIndex::candidateBlocks(entries.data(), entries.size(), TrigramIndex::queryKeys({"link", "main"}), &blocks);
+    QCOMPARE(blocks, std::vector<std::uint32_t>{2});
+
+    // Too short to narrow anything down
+    QVERIFY(TrigramIndex::queryKeys({"ab"}).empty());
+}
+
+void LogSearchTest::requiredLiterals_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QStringList>("literals");
+
+    QTest::newRow("plain") << "undefined reference to" << QStringList{"undefined reference to"};
+    QTest::newRow("wildcard") << "foo.*bar" << QStringList{"foo", "bar"};
+    QTest::newRow("optional character") << "colou?r" << QStringList{"colo", "r"};
+    QTest::newRow("repeat count") << "x{2,3}yz" << QStringList{"yz"};
+    QTest::newRow("group") << "(warning)s" << QStringList{"s"};
+    QTest::newRow("class") << "[a-z]+_test" << QStringList{"_test"};
+    QTest::newRow("posix class") << "[[:alpha:]]xyz" << QStringList{"xyz"};
+    QTest::newRow("alternation") << "error|warning" << QStringList();
+    QTest::newRow("inline option") << "(?i)abc" << QStringList();
+    QTest::newRow("escaped punctuation") << "libQt6\\.so" << QStringList{"libQt6.so"};
+    QTest::newRow("class escape") << "\\d+ errors" << QStringList{" errors"};
+    QTest::newRow("word boundary") << "\\bword\\b" << QStringList{"word"};
+    QTest::newRow("hex escape") << "\\x41bc" << QStringList{"bc"};
+    QTest::newRow("braced hex escape") << "\\x{41}bc" << QStringList{"bc"};
+    QTest::newRow("octal escape") << "a\\012bcd" << QStringList{"a", "bcd"};
+    QTest::newRow("octal takes two digits") << "\\0123" << QStringList{"3"};
+    QTest::newRow("back reference") << "ab\\12cd" << QStringList{"ab", "cd"};
+    QTest::newRow("property") << "\\p{Lu}abc" << QStringList{"abc"};
+    QTest::newRow("short property") << "\\pLabc" << QStringList{"abc"};
+    QTest::newRow("bare \\N") << "a\\Nbc" << QStringList{"a", "bc"};
+    QTest::newRow("named reference") << "\\k<name>xyz" << QStringList{"xyz"};
+    QTest::newRow("relative reference") << "\\g{-1}xyz" << QStringList{"xyz"};
+    QTest::newRow("control character") << "\\cAxyz" << QStringList{"xyz"};
+    QTest::newRow("quoted text") << "\\Qa.b\\Ecd" << QStringList{"cd"};
+    QTest::newRow("unknown escape stops") << "foo\\uBAR" << QStringList{"foo"};
+}
+
+void LogSearchTest::requiredLiterals()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QStringList, literals);
+
+    QStringList found;
+    for (const std::string &literal : LogSearch::requiredLiterals(pattern)) {
+        found.append(QString::fromStdString(literal));
+    }
+    QCOMPARE(found, literals);
+}
+
+void LogSearchTest::findsRankedHits()
+{
+    LogStore store(SmallChunk, 2);
+    fill(&store);
+
+    LogSearch search;
+    QSignalSpy finished(&search, &LogSearch::finished);
+    QVERIFY(search.start(store, "UNDEFINED reference", LogSearch::Mode::Substring));
+    QVERIFY(search.isRunning());
+    QVERIFY(finished.wait());
+    QVERIFY(!search.isRunning());
+
+    // Errors first, then warnings, then everything else; the last line is in the open chunk
+    QCOMPARE(search.hitCount(), 3);
+    QCOMPARE(search.hit(0), 100);
+    QCOMPARE(search.hit(1), 2500);
+    QCOMPARE(search.hit(2), LineCount - 1);
+    QCOMPARE(search.hit(3), -1);
+    QCOMPARE(search.indexOfHit(2500), 1);
+    QCOMPARE(search.indexOfHit(101), -1);
+}
+
+void LogSearchTest::regexUsesLiterals()
+{
+    LogStore store(SmallChunk, 2);
+    fill(&store);
+
+    LogSearch search;
+    QSignalSpy finished(&search, &LogSearch::finished);
+    QVERIFY(search.start(store, "undefined\\s+reference\\s+to", LogSearch::Mode::Regex));
+    QVERIFY(finished.wait());
+    QCOMPARE(search.hitCount(), 1);
+    QCOMPARE(search.hit(0), 100);
+}
+
+void LogSearchTest::rejectsInvalidRegex()
+{
+    LogStore store;
+    LogSearch search;
+    QString errorString;
+    QVERIFY(!search.start(store, "(unclosed", LogSearch::Mode::Regex, &errorString));
+    QVERIFY(!errorString.isEmpty());
+    QVERIFY(!search.isRunning());
+}
+
+void LogSearchTest::cancelDropsResults()
+{
+    LogStore store(SmallChunk, 2);
+    fill(&store);
+
+    LogSearch search;
+    QSignalSpy finished(&search, &LogSearch::finished);
+    QVERIFY(search.start(store, "line", LogSearch::Mode::Substring));
+    search.cancel();
+    QVERIFY(!search.isRunning());
+
+    // Whatever the task still delivers belongs to no search
+    QTest::qWait(200);
+    QCOMPARE(finished.count(), 0);
+    QCOMPARE(search.hitCount(), 0);
+}
+
+QTEST_GUILESS_MAIN(LogSearchTest)
+
+#include "tst_logsearch.moc"
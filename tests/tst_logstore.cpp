@@ -0,0 +1,246 @@
+#include <QtTest>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "logstore.h"
+#include "trigramindex.h"
+
+class LogStoreTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTripsLines();
+    void spillsAndMapsBack();
+    void keepsLinesLongerThanAChunk();
+    void shrinksHotWindow();
+    void snapshotLoadsEveryChunk();
+    void snapshotIgnoresLaterAppends();
+    void snapshotReadsOnlyRequestedLines();
+    void clearStartsOver();
+
+private:
+    static constexpr qsizetype SmallChunk = 256;
+    static constexpr int LineCount = 2000;
+
+    static LogLine makeLine(int i);
+    static void verifyLine(const LogStore &store, int i);
+    static void fill(LogStore *store, int count);
+};
+
+LogLine LogStoreTest::makeLine(int i)
+{
+    LogLine line{"line " + QByteArray::number(i) + " of the log", LineClass(i % 8)};
+    line.channel = LogChannel(i % 3);
+    line.sequence = quint64(i) * 2;
+    line.timestampUs = qint64(i) * 1000 + 7;
+    if (i % 7 == 0) {
+        line.spans = {{0, 4, 0x12345}, {5, quint32(QByteArray::number(i).size()), 0x6789a}};
+    }
+    return line;
+}
+
+void LogStoreTest::verifyLine(const LogStore &store, int i)
+{
+    const LogLine expected = makeLine(i);
+    QCOMPARE(store.line(i).toByteArray(), expected.text);
+    QCOMPARE(store.lineClass(i), expected.lineClass);
+    QCOMPARE(store.channel(i), expected.channel);
+    QCOMPARE(store.sequence(i), expected.sequence);
+    QCOMPARE(store.timestampUs(i), expected.timestampUs);
+    QCOMPARE(store.hasSpans(i), !expected.spans.isEmpty());
+
+    const StyleSpans spans = store.spans(i);
+    QCOMPARE(spans.size(), expected.spans.size());
+    for (qsizetype s = 0; s < spans.size(); ++s) {
+        QCOMPARE(spans.at(s).start, expected.spans.at(s).start);
+        QCOMPARE(spans.at(s).length, expected.spans.at(s).length);
+        QCOMPARE(spans.at(s).style, expected.spans.at(s).style);
+    }
+}
+
+void LogStoreTest::fill(LogStore *store, int count)
+{
+    for (int i = int(store->lineCount()); i < count; ++i) {
+        store->append(makeLine(i));
+    }
+}
+
+void LogStoreTest::roundTripsLines()
+{
+    LogStore store;
+    fill(&store, LineCount);
+    QCOMPARE(store.lineCount(), qsizetype(LineCount));
+    for (int i = 0; i < LineCount; ++i) {
+        verifyLine(store, i);
+        if (QTest::currentTestFailed()) return;
+    }
+}
+
+void LogStoreTest::spillsAndMapsBack()
+{
+    LogStore store(SmallChunk, 1);
+    fill(&store, LineCount);
+
+    // Only one sealed chunk and the open one stay in memory
+    QVERIFY(store.residentBytes() < store.storedBytes() / 10);
+
+    // Backwards, then strided, so chunks are mapped and unmapped again
+    for (int i = LineCount - 1; i >= 0; --i) {
+        verifyLine(store, i);
+        if (QTest::currentTestFailed()) return;
+    }
+    for (int stride = 0; stride < 7; ++stride) {
+        for (int i = stride; i < LineCount; i += 97) {
+            verifyLine(store, i);
+            if (QTest::currentTestFailed()) return;
+        }
+    }
+}
+
+void LogStoreTest::keepsLinesLongerThanAChunk()
+{
+    LogStore store(SmallChunk, 1);
+    fill(&store, 10);
+
+    LogLine longLine{QByteArray(SmallChunk * 4, 'x'), LineClass::Error};
+    store.append(longLine);
+    store.append(makeLine(11));
+    fill(&store, 40);
+
+    QCOMPARE(store.line(10).toByteArray(), longLine.text);
+    QCOMPARE(store.lineClass(10), LineClass::Error);
+    verifyLine(store, 9);
+    verifyLine(store, 11);
+    verifyLine(store, 39);
+}
+
+void LogStoreTest::shrinksHotWindow()
+{
+    LogStore store(SmallChunk, 1000);
+    fill(&store, LineCount);
+    const qint64 resident = store.residentBytes();
+    QVERIFY(resident >= store.storedBytes());
+
+    store.setHotChunks(2);
+    QCOMPARE(store.hotChunks(), 2);
+    QVERIFY(store.residentBytes() < resident / 10);
+    verifyLine(store, 0);
+    verifyLine(store, LineCount - 1);
+}
+
+void LogStoreTest::snapshotLoadsEveryChunk()
+{
+    LogStore store(SmallChunk, 2);
+    fill(&store, LineCount);
+
+    const LogStore::Snapshot snapshot = store.snapshot();
+    QCOMPARE(snapshot.lineCount(), qsizetype(LineCount));
+    QVERIFY(snapshot.chunkCount() > 10);
+
+    const int needle = 1234;
+    const std::vector<std::uint32_t> keys = TrigramIndex::queryKeys({"line " + std::to_string(needle) + " "});
+    const std::vector<std::uint32_t> absent = TrigramIndex::queryKeys({"zzyzx"});
+    QVERIFY(!keys.empty());
+    QVERIFY(!absent.empty());
+
+    qsizetype next = 0;
+    bool needleFound = false;
+    for (qsizetype c = 0; c < snapshot.chunkCount(); ++c) {
+        LogStore::ChunkView view;
+        QVERIFY(snapshot.loadChunk(c, &view));
+        QCOMPARE(view.firstLine, next);
+        QCOMPARE(view.indexed, c + 1 < snapshot.chunkCount());
+
+        for (qsizetype i = 0; i < view.lineCount(); ++i) {
+            const LogLine expected = makeLine(int(next + i));
+            QCOMPARE(view.line(i).toByteArray(), expected.text);
+            QCOMPARE(view.lineClass(i), expected.lineClass);
+        }
+        if (view.indexed) {
+            QVERIFY(!view.trigrams.isEmpty());
+
+            std::vector<std::uint32_t> blocks;
+            TrigramIndex::candidateBlocks(view.trigrams.constData(), std::size_t(view.trigrams.size()), absent, &blocks);
+            QVERIFY(blocks.empty());
+
+            if (needle >= next && needle < next + view.lineCount()) {
+                TrigramIndex::candidateBlocks(view.trigrams.constData(), std::size_t(view.trigrams.size()), keys, &blocks);
+                QVERIFY(std::find(blocks.cbegin(), blocks.cend(), (needle - next) / TrigramIndex::BlockLines) != blocks.cend());
+                needleFound = true;
+            }
+        }
+        next += view.lineCount();
+    }
+    QCOMPARE(next, qsizetype(LineCount));
+    QVERIFY(needleFound);
+}
+
+void LogStoreTest::snapshotIgnoresLaterAppends()
+{
+    LogStore store(SmallChunk, 2);
+    fill(&store, 3);
+
+    const LogStore::Snapshot snapshot = store.snapshot();
+    QCOMPARE(snapshot.chunkCount(), qsizetype(1));
+    fill(&store, LineCount);
+
+    // The open chunk was copied, so lines added since do not show up
+    LogStore::ChunkView view;
+    QVERIFY(snapshot.loadChunk(0, &view));
+    QCOMPARE(view.lineCount(), qsizetype(3));
+    QCOMPARE(view.line(2).toByteArray(), makeLine(2).text);
+    QVERIFY(!view.indexed);
+}
+
+void LogStoreTest::snapshotReadsOnlyRequestedLines()
+{
+    LogStore store(8 * 1024, 1);
+    fill(&store, LineCount);
+
+    const LogStore::Snapshot snapshot = store.snapshot();
+    QVERIFY(snapshot.chunkCount() > 3);
+
+    // The first chunk is spilled, and its index comes without its bytes
+    LogStore::ChunkView view;
+    QVERIFY(snapshot.loadIndex(0, &view));
+    QVERIFY(view.indexed);
+    QVERIFY(!view.trigrams.isEmpty());
+    QVERIFY(view.data.isEmpty());
+
+    const qsizetype block = TrigramIndex::BlockLines;
+    QVERIFY(view.lineCount() > 2 * block);
+    QVERIFY(snapshot.loadLines(0, block, 2 * block, &view));
+    for (qsizetype i = block; i < 2 * block; ++i) {
+        QCOMPARE(view.line(i).toByteArray(), makeLine(int(i)).text);
+    }
+    QVERIFY(view.line(block - 1).isEmpty());
+    QVERIFY(view.line(2 * block).isEmpty());
+
+    // The last line ends where the chunk does
+    const qsizetype last = view.lineCount() - 1;
+    QVERIFY(snapshot.loadLines(0, last, last + 1, &view));
+    QCOMPARE(view.line(last).toByteArray(), makeLine(int(last)).text);
+}
+
+void LogStoreTest::clearStartsOver()
+{
+    LogStore store(SmallChunk, 1);
+    fill(&store, LineCount);
+    store.clear();
+    QCOMPARE(store.lineCount(), qsizetype(0));
+    QCOMPARE(store.storedBytes(), qint64(0));
+    QCOMPARE(store.snapshot().chunkCount(), qsizetype(0));
+
+    // The spill file is reused from its start
+    fill(&store, LineCount);
+    verifyLine(store, 0);
+    verifyLine(store, LineCount / 2);
+    verifyLine(store, LineCount - 1);
+}
+
+QTEST_APPLESS_MAIN(LogStoreTest)
+
+#include "tst_logstore.moc"
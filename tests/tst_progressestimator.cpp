@@ -0,0 +1,116 @@
+#include <QtTest>
+
+#include "progressestimator.h"
+
+class ProgressEstimatorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parsesCounters_data();
+    void parsesCounters();
+    void movesThroughPhases();
+    void neverMovesBackwards();
+    void completesPhase();
+};
+
+void ProgressEstimatorTest::parsesCounters_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<int>("done");
+    QTest::addColumn<int>("total");
+
+    QTest::newRow("ninja") << QByteArray("[1234/5678] Building CXX object a.o") << true << 1234 << 5678;
+    QTest::newRow("make") << QByteArray("[ 45%] Built target Core") << true << 45 << 100;
+    QTest::newRow("make done") << QByteArray("[100%] Linking") << true << 100 << 100;
+    QTest::newRow("over 100 percent") << QByteArray("[101%] x") << false << 0 << 0;
+    QTest::newRow("zero total") << QByteArray("[0/0] x") << false << 0 << 0;
+    QTest::newRow("done over total") << QByteArray("[5/3] x") << false << 0 << 0;
+    QTest::newRow("unterminated") << QByteArray("[12/34 x") << false << 0 << 0;
+    QTest::newRow("not a counter") << QByteArray("[INFO] Building") << false << 0 << 0;
+    QTest::newRow("too many digits") << QByteArray("[1/1234567890] x") << false << 0 << 0;
+    QTest::newRow("too short") << QByteArray("[1]") << false << 0 << 0;
+}
+
+void ProgressEstimatorTest::parsesCounters()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(bool, valid);
+    QFETCH(int, done);
+    QFETCH(int, total);
+
+    int parsedDone = 0;
+    int parsedTotal = 0;
+    QCOMPARE(ProgressEstimator::parseCounter(line, &parsedDone, &parsedTotal), valid);
+    if (valid) {
+        QCOMPARE(parsedDone, done);
+        QCOMPARE(parsedTotal, total);
+    }
+}
+
+void ProgressEstimatorTest::movesThroughPhases()
+{
+    ProgressEstimator progress;
+    progress.setMilestones({20, 30, 50});
+    QCOMPARE(progress.percent(), 0.0);
+
+    // Counters before the first milestone run from 0 to it
+    QVERIFY(progress.addStatusLine("[1/2] Building"));
+    QCOMPARE(progress.percent(), 10.0);
+
+    QVERIFY(progress.reachMilestone(30));
+    QCOMPARE(progress.percent(), 30.0);
+    QCOMPARE(progress.milestone(), 30);
+
+    QVERIFY(progress.addStatusLine("[50/100] Building"));
+    QCOMPARE(progress.percent(), 40.0);
+    QCOMPARE(progress.stepsDone(), 50);
+    QCOMPARE(progress.stepsTotal(), 100);
+
+    // The last phase runs to 100
+    QVERIFY(progress.reachMilestone(50));
+    QVERIFY(progress.addStatusLine("[ 50%] Built target"));
+    QCOMPARE(progress.percent(), 75.0);
+}
+
+void ProgressEstimatorTest::neverMovesBackwards()
+{
+    ProgressEstimator progress;
+    progress.setMilestones({30, 50});
+    progress.reachMilestone(30);
+    progress.addStatusLine("[90/100] Building");
+    QCOMPARE(progress.percent(), 48.0);
+
+    // A second build in the same phase restarts its counter
+    QVERIFY(!progress.addStatusLine("[1/10] Building"));
+    QCOMPARE(progress.percent(), 48.0);
+    QCOMPARE(progress.stepsDone(), 1);
+
+    // Only a higher milestone opens a phase
+    QVERIFY(!progress.reachMilestone(20));
+    QVERIFY(!progress.reachMilestone(30));
+    QCOMPARE(progress.milestone(), 30);
+
+    progress.reset();
+    QCOMPARE(progress.percent(), 0.0);
+    QCOMPARE(progress.milestone(), 0);
+}
+
+void ProgressEstimatorTest::completesPhase()
+{
+    ProgressEstimator progress;
+    progress.setMilestones({30, 50});
+    progress.reachMilestone(30);
+    QVERIFY(progress.completePhase());
+    QCOMPARE(progress.percent(), 50.0);
+    QVERIFY(!progress.completePhase());
+
+    // The next milestone itself moves nothing any more, but opens the phase
+    QVERIFY(!progress.reachMilestone(50));
+    QCOMPARE(progress.milestone(), 50);
+}
+
+QTEST_APPLESS_MAIN(ProgressEstimatorTest)
+
+#include "tst_progressestimator.moc"
@@ -0,0 +1,143 @@
+#include "trigramindex.h"
+
+#include <algorithm>
+#include <iterator>
+
+const std::uint8_t *TrigramIndex::foldTable()
+{
+    // 0 is shared by every byte without a code of its own
+    static const std::vector<std::uint8_t> table = [] {
+        std::vector<std::uint8_t> codes(256, 0);
+        std::uint8_t next = 1;
+        for (int c = 'a'; c <= 'z'; ++c) {
+            codes[c] = codes[c - 'a' + 'A'] = next++;
+        }
+        for (int c = '0'; c <= '9'; ++c) {
+            codes[c] = next++;
+        }
+        for (const char c : std::string(" _-./:+=()<>[],;\"'#@*&%$!|\\")) {
+            codes[std::uint8_t(c)] = next++;
+        }
+        codes['\t'] = codes[' '];
+        return codes;
+    }();
+    return table.data();
+}
+
+void TrigramIndex::addLine(std::uint32_t line, const char *data, std::size_t size)
+{
+    if (size < 3) return;
+    if (pendingSeen.empty()) {
+        pendingSeen.assign(TableSize / 64, 0);
+    }
+
+    const std::uint32_t block = line / BlockLines;
+    if (block != pendingBlock) {
+        flushPending();
+        pendingBlock = block;
+    }
+
+    const std::uint8_t *fold = foldTable();
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+
+    std::uint32_t key = (std::uint32_t(fold[bytes[0]]) << AlphabetBits) | fold[bytes[1]];
+    for (std::size_t i = 2; i < size; ++i) {
+        key = ((key << AlphabetBits) | fold[bytes[i]]) & KeyMask;
+        if (!pendingHas(key)) {
+            pendingSeen[key >> 6] |= std::uint64_t(1) << (key & 63);
+            pendingKeys.push_back(key);
+        }
+    }
+}
+
+void TrigramIndex::flushPending()
+{
+    for (const std::uint32_t key : pendingKeys) {
+        entries.push_back((key << BlockBits) | pendingBlock);
+        pendingSeen[key >> 6] = 0;
+    }
+    pendingKeys.clear();
+}
+
+std::vector<std::uint32_t> TrigramIndex::take()
+{
+    flushPending();
+
+    // Blocks arrive in order, so this groups each trigram's blocks together
+    std::vector<std::uint32_t> sorted;
+    sorted.swap(entries);
+    std::sort(sorted.begin(), sorted.end());
+    pendingBlock = 0;
+    return sorted;
+}
+
+void TrigramIndex::clear()
+{
+    entries.clear();
+    pendingSeen.clear();
+    pendingSeen.shrink_to_fit();
+    pendingKeys.clear();
+    pendingBlock = 0;
+}
+
+std::vector<std::uint32_t> TrigramIndex::queryKeys(const std::vector<std::string> &literals)
+{
+    const std::uint8_t *fold = foldTable();
+
+    std::vector<std::uint32_t> keys;
+    for (const std::string &literal : literals) {
+        if (literal.size() < 3) continue;
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(literal.data());
+        std::uint32_t key = (std::uint32_t(fold[bytes[0]]) << AlphabetBits) | fold[bytes[1]];
+        for (std::size_t i = 2; i < literal.size(); ++i) {
+            key = ((key << AlphabetBits) | fold[bytes[i]]) & KeyMask;
+            keys.push_back(key);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+void TrigramIndex::candidateBlocks(const std::uint32_t *entries, std::size_t count,
+                                   const std::vector<std::uint32_t> &keys, std::vector<std::uint32_t> *blocks)
+{
+    blocks->clear();
+    if (keys.empty()) return;
+
+    // Each key owns one contiguous run of entries
+    struct Run
+    {
+        const std::uint32_t *begin;
+        const std::uint32_t *end;
+    };
+    const std::uint32_t *last = entries + count;
+    std::vector<Run> runs;
+    runs.reserve(keys.size());
+    for (const std::uint32_t key : keys) {
+        const std::uint32_t *begin = std::lower_bound(entries, last, key << BlockBits);
+        const std::uint32_t *end = std::upper_bound(begin, last, (key << BlockBits) | BlockMask);
+        if (begin == end) return;
+        runs.push_back({begin, end});
+    }
+
+    // Intersect the rarest runs first so the running result stays small
+    std::sort(runs.begin(), runs.end(), [](const Run &a, const Run &b) {
+        return a.end - a.begin < b.end - b.begin;
+    });
+
+    for (const std::uint32_t *entry = runs.front().begin; entry != runs.front().end; ++entry) {
+        blocks->push_back(*entry & BlockMask);
+    }
+    std::vector<std::uint32_t> run;
+    std::vector<std::uint32_t> next;
+    for (std::size_t i = 1; i < runs.size() && !blocks->empty(); ++i) {
+        run.clear();
+        for (const std::uint32_t *entry = runs[i].begin; entry != runs[i].end; ++entry) {
+            run.push_back(*entry & BlockMask);
+        }
+        next.clear();
+        std::set_intersection(blocks->begin(), blocks->end(), run.begin(), run.end(), std::back_inserter(next));
+        blocks->swap(next);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Trigram index of one LogStore chunk.
+//
+// Lines are grouped into blocks of BlockLines consecutive lines, and the
+// index is a sorted array of entries that each pack a trigram and a block
+// that contains it into 32 bits. Being flat, it is spilled to disk and read
+// back together with its chunk, so only the indexes of resident chunks take
+// memory. Bytes are folded into a 6-bit alphabet first: case is ignored and
+// rare bytes share one code, so no hashing is needed. The index only narrows
+// a search down to candidate blocks; callers still check every line in them.
+// Trigrams of the block being filled are collected in a bitmap and only
+// turned into entries once the block is complete.
+class TrigramIndex
+{
+public:
+    static constexpr std::uint32_t BlockLines = 32;
+    static constexpr int BlockBits = 14;
+
+    // A chunk must be sealed before it reaches this many lines
+    static constexpr std::uint32_t MaxLines = BlockLines << BlockBits;
+
+    // Lines are numbered from the start of the chunk and added in order
+    void addLine(std::uint32_t line, const char *data, std::size_t size);
+
+    // Sorted entries for everything added so far; the builder starts over
+    std::vector<std::uint32_t> take();
+    void clear();
+
+    // Trigram keys a line must contain to match all of the literals. Empty
+    // if no literal is long enough to narrow the search.
+    static std::vector<std::uint32_t> queryKeys(const std::vector<std::string> &literals);
+
+    // Blocks whose entries hold every key, in increasing order
+    static void candidateBlocks(const std::uint32_t *entries, std::size_t count,
+                                const std::vector<std::uint32_t> &keys, std::vector<std::uint32_t> *blocks);
+
+private:
+    static constexpr int AlphabetBits = 6;
+    static constexpr std::uint32_t TableSize = 1u << (3 * AlphabetBits);
+    static constexpr std::uint32_t KeyMask = TableSize - 1;
+    static constexpr std::uint32_t BlockMask = (1u << BlockBits) - 1;
+
+    static const std::uint8_t *foldTable();
+
+    bool pendingHas(std::uint32_t key) const { return pendingSeen[key >> 6] & (std::uint64_t(1) << (key & 63)); }
+    void flushPending();
+
+    std::vector<std::uint32_t> entries;
+    std::vector<std::uint64_t> pendingSeen;             // keys seen in pendingBlock
+    std::vector<std::uint32_t> pendingKeys;
+    std::uint32_t pendingBlock = 0;
+};
+
+#endif // TRIGRAMINDEX_H